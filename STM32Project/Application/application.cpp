@@ -13,10 +13,23 @@
 //======================================================================================================================
 #include "main.h" // Needed for the pin and port defines.
 #include <cstdint>
+#include <cstring>
 #include <vector> // C++ include. Just to test if the clangd is resolving the correct path. If you use this demo for other stuff, you can delete this and all lines with "=> clangd C++ include test."
 #include "stm32h7xx_hal_gpio.h"
 #include "tx_api.h"
 #include "app_threadx.h" // Contains the export declarations for App_ThreadX_Init() and MX_ThreadX_Init() functions.
+#include "port_debouncer.hpp"
+#include "coro_scheduler.hpp"
+#include "cycle_counter.hpp"
+#include "deferred_work.hpp"
+#include "clock_governor.hpp"
+#include "clock_scaling.hpp"
+#include "cpu_load.hpp"
+#include "rtos_time.hpp"
+#include "crc32_hw.hpp"
+#include "integrity_scanner.hpp"
+
+using namespace rtos::literals; // Duration literals like 10_ms.
 
 
 //======================================================================================================================
@@ -36,6 +49,19 @@ void thrdFct_Main(ULONG thread_input);
 void tmrFct_MainThreadTimer(ULONG timer_input);
 /// Forward declaration of Background thread function:
 void thrdFct_Background(ULONG thread_input);
+/// Forward declaration of Coro thread function:
+void thrdFct_Coro(ULONG thread_input);
+/// Forward declaration of demo coroutine task:
+coro::Task coroTask_Demo();
+/// Forward declaration of Deferred thread function:
+void thrdFct_Deferred(ULONG thread_input);
+/// Forward declaration of demo deferred work function:
+void workFct_Demo(const void* payload);
+/// Linker symbols for the integrity scanner (see startup file and STM32H753XX_FLASH.ld):
+extern "C" const uint32_t g_pfnVectors[]; // Start of the firmware image in flash.
+extern "C" const uint8_t _sidata[];       // Flash address of the init values of the .data section (end of code and constants).
+extern "C" const uint8_t _sdata[];        // Start of the .data section in RAM.
+extern "C" const uint8_t _edata[];        // End of the .data section in RAM.
 
 // --------------------------------------------------------------------------------------------------------------------
 // Typedefs:
@@ -57,6 +83,20 @@ static uint32_t counterLD1 = 0;
 static uint32_t counterLD2 = 0;
 static uint32_t counterLD3 = 0;
 static uint32_t counterButton = 0;
+static uint32_t counterCoroDemo = 0;
+coro::Scheduler coroScheduler; // Runs all coroutine tasks inside the Coro thread.
+static uint32_t counterDeferredDemo = 0;
+static uint32_t lastDeferredDemoTick = 0;
+static uint32_t deferredDemoPostedTick = 0;
+ClockGovernor<clockScaling::opCount> clockGovernor(clockScaling::cpuFreqsHz); // Selects the operating point from the CPU load.
+IdleTimeMeter<CycleCounter> idleTimeMeter; // Measures the idle time (Background thread or no thread running) for the CPU load.
+static uint32_t governorWindowStartCycles = 0;
+static uint32_t governorWindowStartIdleCycles = 0;
+static ULONG governorWindowStartTick = 0;
+static uint32_t governorWindowPeriods = 0;
+DeferredWorkQueue<clockScaling::FixedRateCycleCounter> deferredWork; // Moves work from interrupts to the Deferred thread. The latency histogram is in cycles of 480 MHz at every operating point.
+IntegrityScanner<Crc32Hardware, clockScaling::FixedRateCycleCounter, 5> integrityScanner; // Checks the CRC of the firmware image and the stack guards of the threads in idle time. A pass is shorter than one tick, so it is timed in cycles of 480 MHz.
+PortDebouncer debouncerPortC; // Debounces all inputs of port C (Button1_Blue) with one IDR read per scan.
 std::vector <uint32_t> buttonTimeStamps; // ATTENTION: This vector stores the data in heap memory. This should be avoided in real applications, as it can lead to memory fragmentation and other issues. => clangd C++ include test.
 
 
@@ -67,6 +107,13 @@ std::vector <uint32_t> buttonTimeStamps; // ATTENTION: This vector stores the da
 // Some constants to configure the application:
 constexpr uint8_t counterMain1Max = 10;
 constexpr uint8_t counterMain2Max = 100;
+constexpr rtos::Ticks coroDemoPeriod = 100_ms;
+constexpr uint32_t governorWindowPeriodsMax = 10; // Number of Main periods per load measurement window of the clock governor (100 ms).
+constexpr uint32_t governorWindowPeriodsPostponeMax = 50; // Max. number of Main periods of a postponed window (500 ms). The DWT cycle difference wraps around after approx. 8.9 s.
+constexpr uint32_t deferredDemoPeriodInMillis = 100; // Period of the demo work items posted by the HAL time base interrupt.
+constexpr std::size_t integritySliceBytes = 1024; // Max. number of bytes checked by the integrity scanner per Background loop.
+constexpr std::size_t stackGuardBytes = 64; // Lowest bytes of each thread stack, which must keep the ThreadX stack fill pattern.
+constexpr rtos::Ticks debounceScanPeriod = 5_ms; // Period of the input scans. A pin is stable after 4 equal scans (20 ms).
 
 
 //======================================================================================================================
@@ -74,22 +121,45 @@ constexpr uint8_t counterMain2Max = 100;
 //======================================================================================================================
 
 /// --------------------------------------------------------------------------------------------------------------------
-/// \brief   Converts milliseconds to timer ticks.
-/// \details This function converts a duration in milliseconds to the equivalent duration in timer ticks.
-///          Template parameter T specifies the return type (e.g., ULONG, uint32_t, uint16_t).
+/// \brief   Runs the clock governor.
+/// \details This function is called at the end of every Main period. The cyclic application code is done and no other
+///          application thread is running. Every [governorWindowPeriodsMax] periods the CPU load of the window is
+///          evaluated: the window time minus the idle time (Background thread or no thread running).
+///          While a UART transmission is in progress, the evaluation is postponed to the next period, because a
+///          switch re-initializes USART3. A window, which is postponed for more than [governorWindowPeriodsPostponeMax]
+///          periods, is dropped and a new one is started, so the cycle differences cannot wrap around.
 /// --------------------------------------------------------------------------------------------------------------------
-template <typename T = uint32_t>
-static inline T millisToTicks(T millis)
+static void updateClockGovernor()
 {
-    constexpr uint64_t millisPerSec = 1000;
-    if (millis == 0)
+    governorWindowPeriods++;
+    if (governorWindowPeriods < governorWindowPeriodsMax)
+    {
+        return;
+    }
+    const bool safePoint = clockScaling::isSafePoint();
+    if (!safePoint && governorWindowPeriods < governorWindowPeriodsPostponeMax)
+    {
+        return;
+    }
+
+    // Evaluate the window (or drop it, if it was postponed too long):
+    const ULONG nowTick = tx_time_get();
+    clockGovernor.accountTime(nowTick - governorWindowStartTick);
+    if (safePoint)
     {
-        return static_cast<T>(0); // NOLINT(readability-braces-around-statements)
+        const uint32_t windowCycles = CycleCounter::now() - governorWindowStartCycles;
+        const uint32_t idleCycles = idleTimeMeter.idleTime() - governorWindowStartIdleCycles;
+        const uint32_t busyCycles = (idleCycles < windowCycles) ? (windowCycles - idleCycles) : 0;
+        const std::size_t fromIndex = clockGovernor.current();
+        const std::size_t toIndex = clockGovernor.evaluate(busyCycles, windowCycles);
+        clockScaling::apply(fromIndex, toIndex);
     }
-    // Integer ceil-Division: (a + b - 1) / b
-    uint64_t numerator = (uint64_t)millis * (uint64_t)TX_TIMER_TICKS_PER_SECOND;
-    uint64_t ticks = (numerator + (millisPerSec - 1)) / millisPerSec;
-    return static_cast<T>(ticks);
+
+    // Start the next window (after the switch, so the window is measured with one clock only):
+    governorWindowPeriods = 0;
+    governorWindowStartCycles = CycleCounter::now();
+    governorWindowStartIdleCycles = idleTimeMeter.idleTime();
+    governorWindowStartTick = nowTick;
 }
 
 
@@ -190,6 +260,163 @@ void createThread_Background(VOID* ptrRtosMemoryPool)
 }
 
 
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Handle for Coro thread.
+/// \details  This structure contains the thread control block.
+/// --------------------------------------------------------------------------------------------------------------------
+TX_THREAD thrdHdl_Coro;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the Coro Thread
+/// \details    This function is called in App_ThreadX_Init() to create and configure the thread.
+///             The thread hosts the coroutine scheduler. All coroutine tasks share its stack.
+/// --------------------------------------------------------------------------------------------------------------------
+void createThread_Coro(VOID* ptrRtosMemoryPool)
+{
+    // --- Thread settings:
+    TX_THREAD* thrdCtrlBlk = &thrdHdl_Coro;                 // Configure here the thread control block as handle to the thread. This must be declared in global area to use it e.g. in tx_thread_suspend. Use the pattern 'thrdHdl_[NameOfThread]'. Keep it short!
+    CHAR thrdName[] = "thrd_Coro";                          // Configure here a thread name. Use the pattern 'thrd_[NameOfThread]'. Keep it short!
+    void (*thrdFctPtr)(ULONG param) = &thrdFct_Coro;        // Configure here the function name of the thread function. Use the pattern 'thrdFct_[NameOfThread]'. Keep it short!
+    constexpr ULONG thrdParam = 0;                          // Configure here the parameter of the thread function.
+    constexpr ULONG stackSize = 1 * 1024;                   // Configure here the maximum size of the stack for this thread.
+    constexpr UINT priority = 16;                           // Configure here initial thread priority (lower value = higher priority).
+    constexpr UINT preemptionThreshold = priority;          // Configure here the preemption threshold (limits which threads can preempt this one).
+    constexpr ULONG timeSlice = TX_NO_TIME_SLICE;           // Configure here the time slice value (TX_NO_TIME_SLICE = 0: disables time slicing for this thread).
+    constexpr UINT autoStart = TX_AUTO_START;               // Configure here the auto-start option (TX_AUTO_START thread starts automatically after creation or TX_DONT_START thread don't start).
+
+    // --- Allocate the memory:
+    VOID* ptrToStack = nullptr;
+    UINT result = tx_byte_allocate((TX_BYTE_POOL*)ptrRtosMemoryPool, &ptrToStack, stackSize, TX_NO_WAIT);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+
+    // --- Create the Thread:
+    result = tx_thread_create(thrdCtrlBlk, &thrdName[0], thrdFctPtr, thrdParam, ptrToStack, stackSize, priority, preemptionThreshold, timeSlice, autoStart);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Handle for Deferred thread.
+/// \details  This structure contains the thread control block.
+/// --------------------------------------------------------------------------------------------------------------------
+TX_THREAD thrdHdl_Deferred;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the Deferred Thread
+/// \details    This function is called in App_ThreadX_Init() to create and configure the thread.
+///             The thread executes the work items, which are posted by interrupts into the deferred work queue.
+/// --------------------------------------------------------------------------------------------------------------------
+void createThread_Deferred(VOID* ptrRtosMemoryPool)
+{
+    // --- Thread settings:
+    TX_THREAD* thrdCtrlBlk = &thrdHdl_Deferred;             // Configure here the thread control block as handle to the thread. This must be declared in global area to use it e.g. in tx_thread_suspend. Use the pattern 'thrdHdl_[NameOfThread]'. Keep it short!
+    CHAR thrdName[] = "thrd_Deferred";                      // Configure here a thread name. Use the pattern 'thrd_[NameOfThread]'. Keep it short!
+    void (*thrdFctPtr)(ULONG param) = &thrdFct_Deferred;    // Configure here the function name of the thread function. Use the pattern 'thrdFct_[NameOfThread]'. Keep it short!
+    constexpr ULONG thrdParam = 0;                          // Configure here the parameter of the thread function.
+    constexpr ULONG stackSize = 1 * 1024;                   // Configure here the maximum size of the stack for this thread.
+    constexpr UINT priority = 2;                            // Configure here initial thread priority (lower value = higher priority). This is the priority of all deferred work.
+    constexpr UINT preemptionThreshold = priority;          // Configure here the preemption threshold (limits which threads can preempt this one).
+    constexpr ULONG timeSlice = TX_NO_TIME_SLICE;           // Configure here the time slice value (TX_NO_TIME_SLICE = 0: disables time slicing for this thread).
+    constexpr UINT autoStart = TX_AUTO_START;               // Configure here the auto-start option (TX_AUTO_START thread starts automatically after creation or TX_DONT_START thread don't start).
+
+    // --- Allocate the memory:
+    VOID* ptrToStack = nullptr;
+    UINT result = tx_byte_allocate((TX_BYTE_POOL*)ptrRtosMemoryPool, &ptrToStack, stackSize, TX_NO_WAIT);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+
+    // --- Create the Thread:
+    result = tx_thread_create(thrdCtrlBlk, &thrdName[0], thrdFctPtr, thrdParam, ptrToStack, stackSize, priority, preemptionThreshold, timeSlice, autoStart);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Coroutine Tasks Config
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the coroutine tasks.
+/// \details    This function is called in App_ThreadX_Init() to spawn the tasks into the coroutine scheduler.
+///             The frames of the tasks are allocated from the static arena, see coro_scheduler.hpp.
+/// --------------------------------------------------------------------------------------------------------------------
+void createCoroTasks()
+{
+    if (!coroScheduler.spawn(coroTask_Demo()))
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Integrity Scanner Config
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the integrity scanner.
+/// \details    This function is called in App_ThreadX_Init() after the creation of the threads to configure the CRC
+///             peripheral and register the regions:
+///             - Firmware image: the reference CRC is taken from the first pass.
+///             - Stack guards: ThreadX fills each stack with TX_STACK_FILL at thread creation. The lowest
+///               [stackGuardBytes] of a stack keep this pattern, until the thread (nearly) overflows its stack.
+///             Add further static RAM regions here (and increase the number of regions of integrityScanner).
+/// --------------------------------------------------------------------------------------------------------------------
+void createIntegrityScanner()
+{
+    Crc32Hardware::init();
+
+    // Firmware image: vector table, code, constants and the init values of the .data section:
+    const uintptr_t imageStart = reinterpret_cast<uintptr_t>(&g_pfnVectors[0]);
+    const uintptr_t imageEnd = reinterpret_cast<uintptr_t>(&_sidata[0]) + (reinterpret_cast<uintptr_t>(&_edata[0]) - reinterpret_cast<uintptr_t>(&_sdata[0]));
+    bool result = integrityScanner.addRegion(&g_pfnVectors[0], imageEnd - imageStart);
+
+    // Stack guards of all threads, compared with the CRC of the fill pattern:
+    uint8_t stackFill[stackGuardBytes];
+    std::memset(&stackFill[0], static_cast<uint8_t>(TX_STACK_FILL), sizeof(stackFill));
+    const uint32_t stackFillCrc = Crc32Hardware::calculate(&stackFill[0], sizeof(stackFill));
+    for (const TX_THREAD* thread : {&thrdHdl_Main, &thrdHdl_Background, &thrdHdl_Coro, &thrdHdl_Deferred})
+    {
+        result = result && integrityScanner.addRegion(thread->tx_thread_stack_start, stackGuardBytes, stackFillCrc);
+    }
+    if (!result)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+}
+
+
 //======================================================================================================================
 // MARK: Event Flags Config
 //======================================================================================================================
@@ -230,6 +457,86 @@ void createEventFlags_Main()
 }
 
 
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Event Flag Group for Deferred thread.
+/// \details  This struct holds the state of the event flags.
+/// --------------------------------------------------------------------------------------------------------------------
+TX_EVENT_FLAGS_GROUP evtFlags_Deferred;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Event flag for Deferred thread wake-up.
+/// \details  This defines the bit position of the event flag.
+/// --------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t evtFlag_Deferred_WakeUp = 0x00000001;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the event flags for deferred thread.
+/// \details    This function is called in App_ThreadX_Init() to create and configure the event flags.
+///             The event flags are handed over to the deferred work queue to wake up the Deferred thread.
+/// --------------------------------------------------------------------------------------------------------------------
+void createEventFlags_Deferred()
+{
+    // --- Event Flags creation:
+    TX_EVENT_FLAGS_GROUP* evtFlags = &evtFlags_Deferred; // Configure here the event flags group as handle to the event flags. This must be declared in global area to use it in application. Use the pattern 'evtFlags_[NameOfEventGroup]'. Keep it short!
+    char evtGrpName[] = "evtGrp_Deferred";               // Configure here the name of the event group. Use the pattern 'evtGrp_[NameOfEventGroup]'. Keep it short!
+
+    // Create the Event Flags Group:
+    uint16_t result = tx_event_flags_create(evtFlags, &evtGrpName[0]);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+
+    // Connect the event flags to the deferred work queue:
+    deferredWork.init(evtFlags, evtFlag_Deferred_WakeUp);
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Event Flag Group for Coro thread.
+/// \details  This struct holds the state of the event flags.
+/// --------------------------------------------------------------------------------------------------------------------
+TX_EVENT_FLAGS_GROUP evtFlags_Coro;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Event flag for Coro thread wake-up.
+/// \details  This defines the bit position of the event flag.
+/// --------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t evtFlag_Coro_WakeUp = 0x00000001;
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Creates the event flags for coro thread.
+/// \details    This function is called in App_ThreadX_Init() to create and configure the event flags.
+///             The coroutine scheduler sleeps on them until the next delay expires or a task is spawned.
+/// --------------------------------------------------------------------------------------------------------------------
+void createEventFlags_Coro()
+{
+    // --- Event Flags creation:
+    TX_EVENT_FLAGS_GROUP* evtFlags = &evtFlags_Coro; // Configure here the event flags group as handle to the event flags. This must be declared in global area to use it in application. Use the pattern 'evtFlags_[NameOfEventGroup]'. Keep it short!
+    char evtGrpName[] = "evtGrp_Coro";               // Configure here the name of the event group. Use the pattern 'evtGrp_[NameOfEventGroup]'. Keep it short!
+
+    // Create the Event Flags Group:
+    uint16_t result = tx_event_flags_create(evtFlags, &evtGrpName[0]);
+    if (result != TX_SUCCESS)
+    {
+        // TODO: Replace it with an error handling mechanism!
+        while (true)
+        {
+        };
+    }
+
+    // Connect the event flags to the coroutine scheduler:
+    coroScheduler.init(evtFlags, evtFlag_Coro_WakeUp);
+}
+
+
 //======================================================================================================================
 // MARK: Timer Config
 //======================================================================================================================
@@ -251,11 +558,11 @@ void createTimer_Main()
     TX_TIMER* tmrCtrlBlk = &tmrHdl_Main;                      // Configure here the timer control block as handle to the timer. This must be declared in global area to use it in application. Use the pattern 'tmrHdl_[NameOfTimer]'. Keep it short!
     CHAR tmrName[] = "tmr_Main";                              // Configure here the name of the timer. Use the pattern 'tmr_[NameOfTimer]'. Keep it short!
     VOID (*tmrFuncPtr)(ULONG tmrId) = tmrFct_MainThreadTimer; // Configure here the function name of the timer function. Use the pattern 'tmrFct_[NameOfTimer]'. Keep it short!
-    const ULONG initialDelayInMillis = 10;                    // Configure here the initial duration for the first timer expiration.
-    const ULONG rescheduleDurationInMillis = 10;              // Configure here the duration for all timer expirations after the first. A zero for this parameter makes the timer a one-shot timer.
+    constexpr rtos::Ticks initialDelay = 10_ms;               // Configure here the initial duration for the first timer expiration.
+    constexpr rtos::Ticks rescheduleDuration = 10_ms;         // Configure here the duration for all timer expirations after the first. A zero for this parameter makes the timer a one-shot timer.
 
     // Create the Timer:
-    UINT result = tx_timer_create(tmrCtrlBlk, &tmrName[0], tmrFuncPtr, 0, millisToTicks<ULONG>(initialDelayInMillis), millisToTicks<ULONG>(rescheduleDurationInMillis), TX_AUTO_ACTIVATE);
+    UINT result = tx_timer_create(tmrCtrlBlk, &tmrName[0], tmrFuncPtr, 0, initialDelay.count(), rescheduleDuration.count(), TX_AUTO_ACTIVATE);
     if (result != TX_SUCCESS)
     {
         // TODO: Replace it with an error handling mechanism!
@@ -291,6 +598,38 @@ void stack_error_handler(TX_THREAD __attribute__((unused)) * thread)
 }
 
 
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Callback functions of the ThreadX scheduler for thread switches (TX_ENABLE_EXECUTION_CHANGE_NOTIFY).
+/// \details    These functions are called in the scheduler with disabled interrupts. Keep them short!
+///             They measure the idle time for the clock governor, see cpu_load.hpp.
+///             _tx_execution_initialize() is called once by tx_kernel_enter().
+/// --------------------------------------------------------------------------------------------------------------------
+extern "C" void _tx_execution_initialize()
+{
+    // Not used: the idle time meter is initialized statically.
+}
+
+extern "C" void _tx_execution_thread_enter()
+{
+    idleTimeMeter.threadEnter(tx_thread_identify());
+}
+
+extern "C" void _tx_execution_thread_exit()
+{
+    idleTimeMeter.threadExit();
+}
+
+extern "C" void _tx_execution_isr_enter()
+{
+    // Not used: interrupts count to the thread they preempt.
+}
+
+extern "C" void _tx_execution_isr_exit()
+{
+    // Not used: interrupts count to the thread they preempt.
+}
+
+
 /// --------------------------------------------------------------------------------------------------------------------
 /// \brief      Callback function for initializing the ThreadX kernel.
 /// \details    This function starts the ThreadX kernel by calling the `tx_kernel_enter` function.
@@ -310,11 +649,21 @@ void MX_ThreadX_Init()
 /// --------------------------------------------------------------------------------------------------------------------
 UINT App_ThreadX_Init(VOID* memory_ptr)
 {
+    // --- Enable the cycle counter for time stamps:
+    CycleCounter::init();
+
     // --- Create threads and timers:
     createThread_Background(memory_ptr);
+    idleTimeMeter.setIdleThread(&thrdHdl_Background);
     //tx_thread_suspend(&thrdHdl_Background); // Suspend the background direct thread until it is resumed by the main thread.
     createThread_Main(memory_ptr);
+    createThread_Coro(memory_ptr);
+    createCoroTasks();
+    createThread_Deferred(memory_ptr);
     createEventFlags_Main();
+    createEventFlags_Deferred();
+    createEventFlags_Coro();
+    createIntegrityScanner();
     createTimer_Main();
 
     // Register the stack error handler
@@ -332,6 +681,28 @@ UINT App_ThreadX_Init(VOID* memory_ptr)
 }
 
 
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Callback function for the HAL time base interrupt (TIM7).
+/// \details    This function is called in HAL_TIM_PeriodElapsedCallback() in main.c in interrupt context.
+///             Keep it short and post all longer work into the deferred work queue.
+/// --------------------------------------------------------------------------------------------------------------------
+extern "C" void App_TimebaseElapsed_Callback(TIM_HandleTypeDef* htim)
+{
+    if (htim->Instance != TIM7)
+    {
+        return;
+    }
+
+    // Demo code: post the current tick as payload every [deferredDemoPeriodInMillis]:
+    uint32_t tick = HAL_GetTick();
+    if ((tick - lastDeferredDemoTick) >= deferredDemoPeriodInMillis)
+    {
+        lastDeferredDemoTick = tick;
+        deferredWork.post(&workFct_Demo, tick);
+    }
+}
+
+
 //======================================================================================================================
 // MARK: Timer Functions
 //======================================================================================================================
@@ -370,6 +741,11 @@ void thrdFct_Main(ULONG __attribute__((unused)) thread_input)
     // Start now the background thread:
     tx_thread_resume(&thrdHdl_Background);
 
+    // Start the first load measurement window of the clock governor:
+    governorWindowStartCycles = CycleCounter::now();
+    governorWindowStartIdleCycles = idleTimeMeter.idleTime();
+    governorWindowStartTick = tx_time_get();
+
     // Infinite loop:
     for (;;)
     {
@@ -396,10 +772,13 @@ void thrdFct_Main(ULONG __attribute__((unused)) thread_input)
             }
         }
 
+        // Scale the clock to the CPU load:
+        updateClockGovernor();
+
         // Wait for the next timer event flag:
         // This implements the time synchronized behavior of the main thread.
         ULONG receivedEvtFlags = 0;
-        tx_event_flags_get(&evtFlags_Main, evtFlag_Main_WakeUp, TX_OR_CLEAR, &receivedEvtFlags, TX_WAIT_FOREVER);
+        tx_event_flags_get(&evtFlags_Main, evtFlag_Main_WakeUp, TX_OR_CLEAR, &receivedEvtFlags, rtos::Ticks::waitForever().count());
     }
 }
 
@@ -410,7 +789,11 @@ void thrdFct_Main(ULONG __attribute__((unused)) thread_input)
 ///             It continuously executes in an infinite loop with lowest priority (31) to use the free processing time.
 /// --------------------------------------------------------------------------------------------------------------------
 void thrdFct_Background(ULONG __attribute__((unused)) thread_input)
-{    
+{
+    // Init the debouncing:
+    rtos::TickTimePoint lastScan = rtos::TickTimePoint::now();
+    debouncerPortC = PortDebouncer(static_cast<uint16_t>(Button1_Blue_GPIO_Port->IDR));
+
     // Infinite loop:
     for (;;)
     {
@@ -420,22 +803,84 @@ void thrdFct_Background(ULONG __attribute__((unused)) thread_input)
             // Increment demo counter:
             counterBackground++;
 
-            // Check if button B1 is pressed (active high)
-            // TODO: Insert debouncing.
-            if (HAL_GPIO_ReadPin(Button1_Blue_GPIO_Port, Button1_Blue_Pin) == GPIO_PIN_SET)
+            // Check the integrity of the next slice of flash and the stack guards.
+            // The slice is short and the thread can be preempted at any time, so Main is not delayed:
+            integrityScanner.step(integritySliceBytes);
+
+            // Scan and debounce all inputs of port C every [debounceScanPeriod]:
+            rtos::TickTimePoint now = rtos::TickTimePoint::now();
+            if ((now - lastScan) < debounceScanPeriod)
             {
-                if (HAL_GPIO_ReadPin(LED3_Red_GPIO_Port, LED3_Red_Pin) == GPIO_PIN_RESET)
-                {
-                    counterButton++;
-                    counterLD3++;
-                    buttonTimeStamps.push_back(counterBackground); // => clangd C++ include test.
-                    HAL_GPIO_WritePin(LED3_Red_GPIO_Port, LED3_Red_Pin, GPIO_PIN_SET);
-                }
+                continue;
             }
-            else
+            lastScan = now;
+            debouncerPortC.scan(Button1_Blue_GPIO_Port);
+
+            // Count the presses of button B1 (active high):
+            if (debouncerPortC.pressed() & Button1_Blue_Pin)
             {
-                HAL_GPIO_WritePin(LED3_Red_GPIO_Port, LED3_Red_Pin, GPIO_PIN_RESET);
+                counterButton++;
+                counterLD3++;
+                buttonTimeStamps.push_back(counterBackground); // => clangd C++ include test.
             }
+
+            // LED3 shows the debounced state of button B1. This also clears LED3, which is switched on at startup:
+            HAL_GPIO_WritePin(LED3_Red_GPIO_Port, LED3_Red_Pin, (debouncerPortC.state() & Button1_Blue_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET);
         }
     }
 }
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Coro thread function.
+/// \details    This function runs the coroutine scheduler, which executes all coroutine tasks cooperatively.
+/// --------------------------------------------------------------------------------------------------------------------
+void thrdFct_Coro(ULONG __attribute__((unused)) thread_input)
+{
+    coroScheduler.run();
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Deferred thread function.
+/// \details    This function executes the work items of the deferred work queue. It sleeps while the queue is empty.
+/// --------------------------------------------------------------------------------------------------------------------
+void thrdFct_Deferred(ULONG __attribute__((unused)) thread_input)
+{
+    deferredWork.runWorker();
+}
+
+
+//======================================================================================================================
+// MARK: Coroutine Tasks
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Demo coroutine task.
+/// \details    This task increments a demo counter every [coroDemoPeriod].
+///             Place here a state machine, which does not need its own thread.
+/// --------------------------------------------------------------------------------------------------------------------
+coro::Task coroTask_Demo()
+{
+    for (;;)
+    {
+        co_await coro::delay(coroDemoPeriod);
+        counterCoroDemo++;
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Deferred Work Functions
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Demo deferred work function.
+/// \details    This function is executed in the Deferred thread. The payload is the HAL tick of the posting interrupt.
+/// --------------------------------------------------------------------------------------------------------------------
+void workFct_Demo(const void* payload)
+{
+    const uint32_t postedTick = *static_cast<const uint32_t*>(payload);
+    counterDeferredDemo++;
+    deferredDemoPostedTick = postedTick;
+}
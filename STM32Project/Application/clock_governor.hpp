@@ -0,0 +1,120 @@
+/// ====================================================================================================================
+/// \file       clock_governor.hpp
+/// \brief      Header-only decision logic for load-driven dynamic clock scaling.
+/// \details    The governor gets the busy cycles and the total cycles of a measurement window and selects an
+///             operating point (index 0 = fastest, index N-1 = slowest):
+///             - Step up:   If the load reaches [upThresholdPercent], the governor jumps directly to the fastest
+///                          operating point. So a load peak is handled with minimal latency.
+///             - Step down: If the load projected to the next slower operating point stays below
+///                          [downThresholdPercent] for [downDelayWindows] consecutive windows, the governor steps down
+///                          by one operating point. The gap between both thresholds is the hysteresis.
+///             The logic does not depend on HAL or ThreadX. So it can be tested on a host with load traces.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstddef>
+#include <cstdint>
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Configuration of the clock governor.
+/// --------------------------------------------------------------------------------------------------------------------
+struct ClockGovernorConfig
+{
+    uint32_t upThresholdPercent = 75;   ///< Load at or above this value switches to the fastest operating point.
+    uint32_t downThresholdPercent = 40; ///< Max. projected load at the next slower operating point to step down.
+    uint32_t downDelayWindows = 5;      ///< Number of consecutive windows with low load needed to step down.
+};
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Selects the operating point out of N operating points and tracks the residency of each of them.
+/// \details  The operating points are given by their CPU frequencies in descending order.
+/// --------------------------------------------------------------------------------------------------------------------
+template <std::size_t N>
+class ClockGovernor
+{
+public:
+    static_assert(N > 0, "At least one operating point is needed.");
+
+    constexpr ClockGovernor(const uint32_t (&cpuFreqsHz)[N], ClockGovernorConfig config = {}) : config_(config)
+    {
+        for (std::size_t i = 0; i < N; i++)
+        {
+            cpuFreqsHz_[i] = cpuFreqsHz[i];
+        }
+    }
+
+    /// Evaluates one measurement window and returns the index of the operating point to use.
+    /// The caller has to apply the operating point, if it differs from the previous one.
+    constexpr std::size_t evaluate(uint32_t busyCycles, uint32_t windowCycles)
+    {
+        lastLoadPercent_ = (windowCycles == 0) ? 0 : static_cast<uint32_t>((static_cast<uint64_t>(busyCycles) * 100) / windowCycles);
+
+        // Step up to the fastest operating point:
+        if (lastLoadPercent_ >= config_.upThresholdPercent)
+        {
+            lowLoadWindows_ = 0;
+            current_ = 0;
+            return current_;
+        }
+
+        // Step down by one operating point, if the load at the slower operating point stays low:
+        if (current_ + 1 < N)
+        {
+            const uint64_t projectedLoadPercent = (static_cast<uint64_t>(lastLoadPercent_) * cpuFreqsHz_[current_]) / cpuFreqsHz_[current_ + 1];
+            if (projectedLoadPercent < config_.downThresholdPercent)
+            {
+                lowLoadWindows_++;
+                if (lowLoadWindows_ >= config_.downDelayWindows)
+                {
+                    lowLoadWindows_ = 0;
+                    current_++;
+                }
+                return current_;
+            }
+        }
+        lowLoadWindows_ = 0;
+        return current_;
+    }
+
+    /// Adds the elapsed time to the residency of the current operating point.
+    constexpr void accountTime(uint32_t ticks)
+    {
+        residencyTicks_[current_] += ticks;
+    }
+
+    /// Returns the index of the current operating point.
+    constexpr std::size_t current() const
+    {
+        return current_;
+    }
+
+    /// Returns the load of the last evaluated window in percent.
+    constexpr uint32_t lastLoadPercent() const
+    {
+        return lastLoadPercent_;
+    }
+
+    /// Returns the time spent at the given operating point.
+    constexpr uint64_t residencyTicks(std::size_t index) const
+    {
+        return residencyTicks_[index];
+    }
+
+private:
+    ClockGovernorConfig config_;
+    uint32_t cpuFreqsHz_[N] = {};
+    uint64_t residencyTicks_[N] = {};
+    std::size_t current_ = 0; // Start at the fastest operating point (as configured by SystemClock_Config()).
+    uint32_t lowLoadWindows_ = 0;
+    uint32_t lastLoadPercent_ = 0;
+};
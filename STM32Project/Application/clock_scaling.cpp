@@ -0,0 +1,238 @@
+/// ====================================================================================================================
+/// \file       clock_scaling.cpp
+/// \brief      This file contains the operating points of the CPU and the switching between them.
+/// \details    All operating points use the same PLL1 VCO (HSE 5 MHz / M 1 * N 192 = 960 MHz). Only the divider P is
+///             changed. So the PLL1 Q and R outputs keep their frequencies.
+///             Sequence of a switch:
+///             1. Raise the voltage scale (if the new operating point needs a higher one).
+///             2. Switch SYSCLK to HSE, reconfigure PLL1 and switch SYSCLK back to PLL1 with the new flash latency.
+///             3. Lower the voltage scale (if the new operating point allows a lower one).
+///             4. Re-derive the clock dependent settings (SysTick, USART3 incl. an armed reception).
+///             The fixed rate cycle counter is stopped before step 1 and continues with the new factor after step 4.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include "clock_scaling.hpp"
+#include "main.h"
+#include "usart.h" // Needed for huart3.
+#include "tx_api.h"
+#include "cycle_counter.hpp"
+
+
+//======================================================================================================================
+// MARK: Globals
+//======================================================================================================================
+
+// --------------------------------------------------------------------------------------------------------------------
+// Typedefs:
+// --------------------------------------------------------------------------------------------------------------------
+/// Settings of one operating point.
+struct OperatingPoint
+{
+    uint32_t pllP;          ///< PLL1 divider P (SYSCLK = 960 MHz / pllP).
+    uint32_t voltageScale;  ///< Regulator voltage scale (PWR_REGULATOR_VOLTAGE_SCALEx).
+    uint32_t flashLatency;  ///< Flash wait states for HCLK = SYSCLK / 2 at this voltage scale (FLASH_LATENCY_x).
+};
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// Constants:
+// --------------------------------------------------------------------------------------------------------------------
+/// Operating points, same order as clockScaling::cpuFreqsHz.
+static const OperatingPoint operatingPoints[clockScaling::opCount] = {
+    {2, PWR_REGULATOR_VOLTAGE_SCALE0, FLASH_LATENCY_4}, // 480 MHz CPU, 240 MHz HCLK (same as SystemClock_Config()).
+    {4, PWR_REGULATOR_VOLTAGE_SCALE1, FLASH_LATENCY_2}, // 240 MHz CPU, 120 MHz HCLK.
+    {8, PWR_REGULATOR_VOLTAGE_SCALE3, FLASH_LATENCY_2}, // 120 MHz CPU,  60 MHz HCLK.
+};
+
+/// Returns true, if the CPU frequencies of all operating points divide the fastest one without remainder.
+static constexpr bool hasIntegerFixedRateFactors()
+{
+    for (uint32_t cpuFreqHz : clockScaling::cpuFreqsHz)
+    {
+        if ((clockScaling::cpuFreqsHz[0] % cpuFreqHz) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(hasIntegerFixedRateFactors(), "The fixed rate cycle counter needs integer factors between the CPU frequencies.");
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// Variables:
+// --------------------------------------------------------------------------------------------------------------------
+// State of the fixed rate cycle counter, only changed with disabled interrupts:
+static uint32_t fixedRateCyclesAtSwitch = 0; // Value of the fixed rate cycle counter at the last switch.
+static uint32_t dwtCyclesAtSwitch = 0;       // Value of the DWT cycle counter at the last switch.
+static uint32_t fixedRateFactor = 1;         // cpuFreqsHz[0] / cpuFreqsHz[current], 0 during a switch.
+
+
+//======================================================================================================================
+// MARK: Helper
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Sets the regulator voltage scale and waits until it is ready.
+/// --------------------------------------------------------------------------------------------------------------------
+static void setVoltageScale(uint32_t voltageScale)
+{
+    if (HAL_PWREx_ControlVoltageScaling(voltageScale) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Reconfigures PLL1 and the bus clocks for the given operating point.
+/// \details    The bus dividers are the same as in SystemClock_Config().
+/// --------------------------------------------------------------------------------------------------------------------
+static void configureClocks(const OperatingPoint& from, const OperatingPoint& to)
+{
+    // Switch SYSCLK to HSE, because PLL1 can only be reconfigured when it is not the system clock.
+    // Keep the flash latency of the current operating point, it is enough for HSE.
+    RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+    RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_SYSCLK;
+    RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSE;
+    if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, from.flashLatency) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // Reconfigure PLL1:
+    RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+    RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+    RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+    RCC_OscInitStruct.PLL.PLLM = 1;
+    RCC_OscInitStruct.PLL.PLLN = 192;
+    RCC_OscInitStruct.PLL.PLLP = to.pllP;
+    RCC_OscInitStruct.PLL.PLLQ = 4;
+    RCC_OscInitStruct.PLL.PLLR = 2;
+    RCC_OscInitStruct.PLL.PLLRGE = RCC_PLL1VCIRANGE_2;
+    RCC_OscInitStruct.PLL.PLLVCOSEL = RCC_PLL1VCOWIDE;
+    RCC_OscInitStruct.PLL.PLLFRACN = 0;
+    if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // Switch SYSCLK back to PLL1. This updates SystemCoreClock and the HAL time base (TIM7) too:
+    RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK
+                                | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2
+                                | RCC_CLOCKTYPE_D3PCLK1 | RCC_CLOCKTYPE_D1PCLK1;
+    RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    RCC_ClkInitStruct.SYSCLKDivider = RCC_SYSCLK_DIV1;
+    RCC_ClkInitStruct.AHBCLKDivider = RCC_HCLK_DIV2;
+    RCC_ClkInitStruct.APB3CLKDivider = RCC_APB3_DIV2;
+    RCC_ClkInitStruct.APB1CLKDivider = RCC_APB1_DIV2;
+    RCC_ClkInitStruct.APB2CLKDivider = RCC_APB2_DIV2;
+    RCC_ClkInitStruct.APB4CLKDivider = RCC_APB4_DIV2;
+    if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, to.flashLatency) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Re-derives all settings, which depend on the CPU or bus clocks.
+/// --------------------------------------------------------------------------------------------------------------------
+static void updateClockDependencies()
+{
+    // ThreadX tick: The SysTick reload value is calculated once at startup in tx_initialize_low_level.
+    SysTick->LOAD = (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND) - 1;
+    SysTick->VAL = 0;
+
+    // USART3: HAL_UART_Init() recalculates the baud rate register from the new PCLK1 frequency. It resets the
+    // receive state, so an armed reception (interrupt mode, USART3 has no DMA) is stopped before and continued with
+    // the remaining bytes after. Bytes, which arrive during the switch, are lost.
+    const bool rxArmed = (huart3.RxState == HAL_UART_STATE_BUSY_RX);
+    const HAL_UART_RxTypeTypeDef rxType = huart3.ReceptionType;
+    uint8_t* const rxBuffer = huart3.pRxBuffPtr;
+    const uint16_t rxRemaining = huart3.RxXferCount;
+    if (rxArmed && HAL_UART_AbortReceive(&huart3) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    if (HAL_UART_Init(&huart3) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    if (rxArmed && rxRemaining != 0)
+    {
+        const HAL_StatusTypeDef status = (rxType == HAL_UART_RECEPTION_TOIDLE)
+                                         ? HAL_UARTEx_ReceiveToIdle_IT(&huart3, rxBuffer, rxRemaining)
+                                         : HAL_UART_Receive_IT(&huart3, rxBuffer, rxRemaining);
+        if (status != HAL_OK)
+        {
+            Error_Handler();
+        }
+    }
+}
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief      Continues the fixed rate cycle counter with a new factor (0 stops it).
+/// \details    The unsigned arithmetic stays exact, even if the DWT counter wraps around between two switches.
+/// --------------------------------------------------------------------------------------------------------------------
+static void setFixedRateFactor(uint32_t factor)
+{
+    UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+    const uint32_t dwtCycles = CycleCounter::now();
+    fixedRateCyclesAtSwitch += (dwtCycles - dwtCyclesAtSwitch) * fixedRateFactor;
+    dwtCyclesAtSwitch = dwtCycles;
+    fixedRateFactor = factor;
+    tx_interrupt_control(oldPosture);
+}
+
+
+//======================================================================================================================
+// MARK: Interface
+//======================================================================================================================
+
+bool clockScaling::isSafePoint()
+{
+    return huart3.gState == HAL_UART_STATE_READY;
+}
+
+
+uint32_t clockScaling::FixedRateCycleCounter::now()
+{
+    UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+    const uint32_t cycles = fixedRateCyclesAtSwitch + (CycleCounter::now() - dwtCyclesAtSwitch) * fixedRateFactor;
+    tx_interrupt_control(oldPosture);
+    return cycles;
+}
+
+
+void clockScaling::apply(std::size_t fromIndex, std::size_t toIndex)
+{
+    if (fromIndex == toIndex)
+    {
+        return;
+    }
+    const OperatingPoint& from = operatingPoints[fromIndex];
+    const OperatingPoint& to = operatingPoints[toIndex];
+    const bool faster = toIndex < fromIndex;
+    setFixedRateFactor(0);
+
+    // The voltage must be raised before and lowered after the clock change:
+    if (faster)
+    {
+        setVoltageScale(to.voltageScale);
+    }
+    configureClocks(from, to);
+    if (!faster)
+    {
+        setVoltageScale(to.voltageScale);
+    }
+
+    updateClockDependencies();
+    setFixedRateFactor(clockScaling::cpuFreqsHz[0] / clockScaling::cpuFreqsHz[toIndex]);
+}
@@ -0,0 +1,59 @@
+/// ====================================================================================================================
+/// \file       clock_scaling.hpp
+/// \brief      Operating points (PLL and voltage scale) of the CPU and the switching between them.
+/// \details    The operating points are listed from the fastest to the slowest. Index 0 is the operating point
+///             configured by SystemClock_Config() at startup.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstddef>
+#include <cstdint>
+
+
+namespace clockScaling
+{
+    /// Number of operating points.
+    constexpr std::size_t opCount = 3;
+
+    /// CPU frequencies of the operating points in Hz (descending). See clock_scaling.cpp for the complete settings.
+    constexpr uint32_t cpuFreqsHz[opCount] = {480000000, 240000000, 120000000};
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief      Returns true, if the operating point can be switched now.
+    /// \details    apply() re-initializes USART3, which aborts a running transmission. So no transmission must be in
+    ///             progress. A reception may be armed at any time (e.g. for commands), so it does not block a switch:
+    ///             apply() continues it after the re-initialization.
+    /// ----------------------------------------------------------------------------------------------------------------
+    bool isSafePoint();
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief      Switches from one operating point to another.
+    /// \details    Call this only at a safe point: isSafePoint() is true and no timing critical code is running.
+    ///             The function re-derives all clock dependent settings:
+    ///             - SysTick reload for TX_TIMER_TICKS_PER_SECOND (ThreadX tick),
+    ///             - HAL time base TIM7 (done by HAL_RCC_ClockConfig()),
+    ///             - USART3 baud rate register (an armed reception is continued).
+    /// ----------------------------------------------------------------------------------------------------------------
+    void apply(std::size_t fromIndex, std::size_t toIndex);
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief      Cycle counter with the fixed rate of the fastest operating point (cpuFreqsHz[0]).
+    /// \details    The DWT cycle counter runs with the CPU clock, so its durations mix the operating points.
+    ///             This counter scales the DWT cycles by cpuFreqsHz[0] / cpuFreqsHz[current] since the last switch.
+    ///             So durations are in cycles of 480 MHz at every operating point (e.g. for latency histograms or the
+    ///             pass duration of the integrity scanner).
+    ///             The counter stands still during a switch. It wraps around after 2^32 cycles (approx. 8.9 s).
+    ///             Can be called from interrupts and threads.
+    /// ----------------------------------------------------------------------------------------------------------------
+    struct FixedRateCycleCounter
+    {
+        static constexpr uint32_t frequencyHz = cpuFreqsHz[0];
+
+        static uint32_t now();
+    };
+
+} // namespace clockScaling
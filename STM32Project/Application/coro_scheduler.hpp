@@ -0,0 +1,605 @@
+/// ====================================================================================================================
+/// \file       coro_scheduler.hpp
+/// \brief      Header-only cooperative C++20 coroutine scheduler running inside a single ThreadX thread.
+/// \details    Every ThreadX thread needs its own stack (typically 1..2 KB) and a TX_THREAD control block.
+///             A coroutine task only needs its frame, which contains the locals living across a co_await.
+///             The frames are allocated from a static arena with fixed blocks of [frameBlockSize] bytes via the
+///             custom operator new of the promise_type. So no heap and no byte pool memory is used.
+///             All tasks are resumed by Scheduler::run() on the stack of the hosting thread.
+///             Usage:
+///                 coro::Task myTask()
+///                 {
+///                     for (;;)
+///                     {
+///                         co_await coro::delay(10_ms);                                 // Wait 10 ms.
+///                         co_await coro::eventFlags(&grp, 0x1, TX_OR_CLEAR, &actual); // Wait for flag 0x1.
+///                         co_await coro::semaphore(&sem);                             // Get the semaphore.
+///                     }
+///                 }
+///                 coroScheduler.init(&evtFlags_Coro, evtFlag_Coro_WakeUp); // In App_ThreadX_Init().
+///                 coroScheduler.spawn(myTask());                         // e.g. in App_ThreadX_Init().
+///                 coroScheduler.run();                                   // In the thread function of the hosting thread.
+///             ATTENTION: Tasks are cooperative. A task blocks all other tasks until it reaches the next co_await.
+///             Never call blocking ThreadX services (e.g. with TX_WAIT_FOREVER) inside a task.
+///             ATTENTION: Waiting for event flags or a semaphore registers a notify callback on this object
+///             (tx_event_flags_set_notify(), tx_semaphore_put_notify()). This replaces any other notify callback.
+///             Do not let ThreadX threads wait for the same semaphore: tx_semaphore_put() hands the instance
+///             to a suspended thread first, so a coroutine task would starve.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include "tx_api.h"
+#include "rtos_time.hpp"
+
+
+namespace coro
+{
+    //==================================================================================================================
+    // MARK: Config
+    //==================================================================================================================
+    constexpr std::size_t frameBlockSize = 256; // Configure here the maximum size of a coroutine frame in bytes.
+    constexpr std::size_t frameBlockCount = 8;  // Configure here the maximum number of coroutine tasks (max. 32).
+
+    static_assert(frameBlockCount <= 32, "The arena manages the free blocks in a 32 bit mask.");
+
+
+    //==================================================================================================================
+    // MARK: Frame Arena
+    //==================================================================================================================
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Static memory for the coroutine frames.
+    /// \details  The arena consists of [frameBlockCount] blocks with [frameBlockSize] bytes each.
+    ///           A set bit in freeMask_ marks a free block. Allocation and deallocation are O(1).
+    /// ----------------------------------------------------------------------------------------------------------------
+    class FrameArena
+    {
+    public:
+        /// Returns a free block or nullptr if the frame is too large or all blocks are in use.
+        void* allocate(std::size_t size)
+        {
+            if (size > maxFrameSize_)
+            {
+                maxFrameSize_ = size;
+            }
+            if (size > frameBlockSize)
+            {
+                return nullptr;
+            }
+
+            UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+            void* block = nullptr;
+            if (freeMask_ != 0)
+            {
+                const unsigned index = static_cast<unsigned>(__builtin_ctz(freeMask_));
+                freeMask_ &= ~(1UL << index);
+                block = &blocks_[index][0];
+            }
+            tx_interrupt_control(oldPosture);
+            return block;
+        }
+
+        /// Returns the block of the given frame back to the arena.
+        void deallocate(void* ptr)
+        {
+            const std::size_t index = (static_cast<uint8_t*>(ptr) - &blocks_[0][0]) / frameBlockSize;
+
+            UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+            freeMask_ |= (1UL << index);
+            tx_interrupt_control(oldPosture);
+        }
+
+        /// Returns the number of blocks in use (e.g. for live watch).
+        std::size_t used() const
+        {
+            return frameBlockCount - static_cast<std::size_t>(__builtin_popcount(freeMask_));
+        }
+
+        /// Returns the largest requested frame size in bytes (e.g. for live watch to tune frameBlockSize).
+        std::size_t maxFrameSize() const
+        {
+            return maxFrameSize_;
+        }
+
+    private:
+        alignas(std::max_align_t) uint8_t blocks_[frameBlockCount][frameBlockSize] = {};
+        uint32_t freeMask_ = (frameBlockCount == 32) ? 0xFFFFFFFFUL : ((1UL << frameBlockCount) - 1);
+        std::size_t maxFrameSize_ = 0;
+    };
+
+    /// The one and only frame arena used by all coroutine tasks.
+    inline FrameArena frameArena;
+
+
+    //==================================================================================================================
+    // MARK: Notify Callbacks
+    //==================================================================================================================
+
+    class Scheduler;
+
+    namespace detail
+    {
+        /// Scheduler, which is woken up by the notify callbacks (set by Scheduler::init()).
+        inline Scheduler* notifiedScheduler = nullptr;
+
+        /// Notify callback of awaited event flags groups: wakes up the hosting thread of the scheduler.
+        inline void onEventFlagsSet(TX_EVENT_FLAGS_GROUP* group);
+
+        /// Notify callback of awaited semaphores: wakes up the hosting thread of the scheduler.
+        inline void onSemaphorePut(TX_SEMAPHORE* sem);
+    } // namespace detail
+
+
+    //==================================================================================================================
+    // MARK: Task
+    //==================================================================================================================
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Reason why a task is suspended.
+    /// ----------------------------------------------------------------------------------------------------------------
+    enum class WaitKind : uint8_t
+    {
+        Ready,      ///< Task is ready and resumed in the next scheduler pass.
+        Delay,      ///< Task waits until [waitTicks] have elapsed.
+        EventFlags, ///< Task waits for event flags (or the timeout).
+        Semaphore   ///< Task waits for a semaphore instance (or the timeout).
+    };
+
+
+    class Task;
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Promise of a coroutine task.
+    /// \details  It holds the wait condition which is checked by the scheduler.
+    /// ----------------------------------------------------------------------------------------------------------------
+    struct Promise
+    {
+        WaitKind waitKind = WaitKind::Ready;
+        rtos::TickTimePoint waitStart;             ///< Tick of the co_await.
+        rtos::Ticks waitTicks;                     ///< Delay or timeout (waitForever(): no timeout).
+        TX_EVENT_FLAGS_GROUP* flagsGroup = nullptr;
+        ULONG requestedFlags = 0;
+        UINT getOption = TX_OR;
+        ULONG* actualFlags = nullptr;
+        TX_SEMAPHORE* sem = nullptr;
+        UINT status = TX_SUCCESS;                  ///< Result of the last wait, returned by co_await.
+
+        Task get_return_object();
+
+        /// Called instead of get_return_object(), if the frame could not be allocated from the arena.
+        static Task get_return_object_on_allocation_failure();
+
+        static void* operator new(std::size_t size) noexcept
+        {
+            return frameArena.allocate(size);
+        }
+
+        static void operator delete(void* ptr)
+        {
+            frameArena.deallocate(ptr);
+        }
+
+        /// The task is started by the scheduler and not at the call of the coroutine function.
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        /// The finished frame is destroyed by the scheduler.
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            // Exceptions are disabled (-fno-exceptions), so this should never happen.
+            // TODO: Replace it with an error handling mechanism!
+            while (true)
+            {
+            };
+        }
+    };
+
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Return type of all coroutine task functions.
+    /// \details  The object owns the coroutine until it is handed over to Scheduler::spawn().
+    ///           A Task without handle signals that no frame block was available.
+    /// ----------------------------------------------------------------------------------------------------------------
+    class Task
+    {
+    public:
+        using promise_type = Promise;
+        using Handle = std::coroutine_handle<Promise>;
+
+        explicit Task(Handle handle = nullptr) : handle_(handle)
+        {
+        }
+
+        Task(Task&& other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&&) = delete;
+
+        ~Task()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+        }
+
+        /// Hands over the ownership of the coroutine (used by the scheduler).
+        Handle release()
+        {
+            Handle handle = handle_;
+            handle_ = nullptr;
+            return handle;
+        }
+
+    private:
+        Handle handle_;
+    };
+
+
+    inline Task Promise::get_return_object()
+    {
+        return Task(Task::Handle::from_promise(*this));
+    }
+
+    inline Task Promise::get_return_object_on_allocation_failure()
+    {
+        return Task();
+    }
+
+
+    //==================================================================================================================
+    // MARK: Awaitables
+    //==================================================================================================================
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Base of all awaitables: stores the wait condition in the promise of the awaiting task.
+    /// ----------------------------------------------------------------------------------------------------------------
+    struct Awaitable
+    {
+        Promise* promise = nullptr;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        UINT await_resume() const noexcept
+        {
+            return promise->status;
+        }
+    };
+
+
+    /// Suspends the task for the given duration. Returns TX_SUCCESS.
+    inline auto delay(rtos::Ticks duration)
+    {
+        struct DelayAwaitable : Awaitable
+        {
+            rtos::Ticks ticks;
+
+            void await_suspend(Task::Handle handle) noexcept
+            {
+                promise = &handle.promise();
+                promise->waitKind = WaitKind::Delay;
+                promise->waitStart = rtos::TickTimePoint::now();
+                promise->waitTicks = ticks;
+                promise->status = TX_SUCCESS;
+            }
+        };
+        return DelayAwaitable{{}, duration};
+    }
+
+
+    /// Suspends the task until all other ready tasks have been resumed once. Returns TX_SUCCESS.
+    inline auto yield()
+    {
+        return delay(rtos::Ticks::zero());
+    }
+
+
+    /// Suspends the task until the event flags are set, see tx_event_flags_get() for the parameters.
+    /// Returns TX_SUCCESS or TX_NO_EVENTS on timeout.
+    inline auto eventFlags(TX_EVENT_FLAGS_GROUP* group, ULONG requestedFlags, UINT getOption, ULONG* actualFlags, rtos::Ticks timeout = rtos::Ticks::waitForever())
+    {
+        struct EventFlagsAwaitable : Awaitable
+        {
+            TX_EVENT_FLAGS_GROUP* group;
+            ULONG requestedFlags;
+            UINT getOption;
+            ULONG* actualFlags;
+            rtos::Ticks timeout;
+
+            void await_suspend(Task::Handle handle) noexcept
+            {
+                promise = &handle.promise();
+                promise->waitKind = WaitKind::EventFlags;
+                promise->waitStart = rtos::TickTimePoint::now();
+                promise->waitTicks = timeout;
+                promise->flagsGroup = group;
+                promise->requestedFlags = requestedFlags;
+                promise->getOption = getOption;
+                promise->actualFlags = actualFlags;
+                tx_event_flags_set_notify(group, &detail::onEventFlagsSet);
+            }
+        };
+        return EventFlagsAwaitable{{}, group, requestedFlags, getOption, actualFlags, timeout};
+    }
+
+
+    /// Suspends the task until an instance of the semaphore is available.
+    /// Returns TX_SUCCESS or TX_NO_INSTANCE on timeout.
+    inline auto semaphore(TX_SEMAPHORE* sem, rtos::Ticks timeout = rtos::Ticks::waitForever())
+    {
+        struct SemaphoreAwaitable : Awaitable
+        {
+            TX_SEMAPHORE* sem;
+            rtos::Ticks timeout;
+
+            void await_suspend(Task::Handle handle) noexcept
+            {
+                promise = &handle.promise();
+                promise->waitKind = WaitKind::Semaphore;
+                promise->waitStart = rtos::TickTimePoint::now();
+                promise->waitTicks = timeout;
+                promise->sem = sem;
+                tx_semaphore_put_notify(sem, &detail::onSemaphorePut);
+            }
+        };
+        return SemaphoreAwaitable{{}, sem, timeout};
+    }
+
+
+    //==================================================================================================================
+    // MARK: Scheduler
+    //==================================================================================================================
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Cooperative round-robin scheduler for coroutine tasks.
+    /// \details  run() checks the wait condition of all tasks and resumes the ready ones.
+    ///           If no task was resumed during a pass, the hosting thread sleeps until the earliest delay or
+    ///           timeout expires. spawn() and the notify callbacks of the awaited event flags groups and semaphores
+    ///           wake up the sleeping hosting thread via the event flag given to init().
+    ///           Only one scheduler can be woken up by the notify callbacks: the last one passed to init().
+    /// ----------------------------------------------------------------------------------------------------------------
+    class Scheduler
+    {
+    public:
+        Scheduler() = default;
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /// Destroys the frames of all remaining tasks.
+        ~Scheduler()
+        {
+            if (detail::notifiedScheduler == this)
+            {
+                detail::notifiedScheduler = nullptr;
+            }
+            for (Task::Handle& slot : tasks_)
+            {
+                if (slot)
+                {
+                    slot.destroy();
+                }
+            }
+        }
+
+        /// Sets the event flags group to wake up the hosting thread on spawn() and on the notify callbacks.
+        /// Without it, the hosting thread only detects a new task or a set event flag / put semaphore after the
+        /// current sleep (max. the earliest delay or timeout of the other tasks).
+        void init(TX_EVENT_FLAGS_GROUP* evtFlags, ULONG evtFlag)
+        {
+            evtFlags_ = evtFlags;
+            evtFlag_ = evtFlag;
+            detail::notifiedScheduler = this;
+        }
+
+        /// Wakes up the sleeping hosting thread. Can be called from threads and interrupts.
+        void wakeUp()
+        {
+            if (evtFlags_ != nullptr)
+            {
+                tx_event_flags_set(evtFlags_, evtFlag_, TX_OR);
+            }
+        }
+
+        /// Returns true, if the given group is the wake-up event flags group of the hosting thread.
+        bool isWakeUpGroup(const TX_EVENT_FLAGS_GROUP* group) const
+        {
+            return group == evtFlags_;
+        }
+
+        /// Adds a task to the scheduler. Returns false, if the task has no frame (arena exhausted).
+        bool spawn(Task task)
+        {
+            Task::Handle handle = task.release();
+            if (!handle)
+            {
+                return false;
+            }
+
+            UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+            for (Task::Handle& slot : tasks_)
+            {
+                if (!slot)
+                {
+                    slot = handle;
+                    tx_interrupt_control(oldPosture);
+                    wakeUp();
+                    return true;
+                }
+            }
+            tx_interrupt_control(oldPosture);
+
+            // Not reachable: the arena has never more frames than the scheduler has slots.
+            handle.destroy();
+            return false;
+        }
+
+        /// Executes all tasks. Call this in the thread function of the hosting thread. Never returns.
+        [[noreturn]] void run()
+        {
+            for (;;)
+            {
+                bool resumedAny = false;
+                for (Task::Handle& slot : tasks_)
+                {
+                    if (!slot || !isReady(slot.promise(), rtos::TickTimePoint::now()))
+                    {
+                        continue;
+                    }
+
+                    resumedAny = true;
+                    slot.resume();
+                    if (slot.done())
+                    {
+                        Task::Handle finished = slot;
+                        slot = nullptr;
+                        finished.destroy();
+                    }
+                }
+
+                if (!resumedAny)
+                {
+                    sleep(sleepTicks(rtos::TickTimePoint::now()));
+                }
+            }
+        }
+
+        /// Returns the number of active tasks (e.g. for live watch).
+        std::size_t taskCount() const
+        {
+            std::size_t count = 0;
+            for (const Task::Handle& slot : tasks_)
+            {
+                count += slot ? 1 : 0;
+            }
+            return count;
+        }
+
+    private:
+        /// Returns the time until the next delay or timeout expires.
+        /// Waits without timeout are ended by the wake-up event flag (spawn() or notify callbacks).
+        rtos::Ticks sleepTicks(rtos::TickTimePoint now) const
+        {
+            rtos::Ticks ticks = rtos::Ticks::max(); // No timeout: sleep until the thread is woken up.
+            for (const Task::Handle& slot : tasks_)
+            {
+                if (!slot)
+                {
+                    continue;
+                }
+                const Promise& promise = slot.promise();
+                if (promise.waitKind == WaitKind::Ready)
+                {
+                    return rtos::Ticks::zero();
+                }
+                const rtos::Ticks remaining = promise.waitTicks - (now - promise.waitStart); // Stays waitForever().
+                if (remaining < ticks)
+                {
+                    ticks = remaining;
+                }
+            }
+            return ticks;
+        }
+
+        /// Sleeps for the given ticks or until the wake-up event flag is set.
+        void sleep(rtos::Ticks ticks)
+        {
+            if (ticks == rtos::Ticks::zero())
+            {
+                return;
+            }
+            if (evtFlags_ == nullptr)
+            {
+                tx_thread_sleep(ticks.count());
+                return;
+            }
+            ULONG receivedEvtFlags = 0;
+            tx_event_flags_get(evtFlags_, evtFlag_, TX_OR_CLEAR, &receivedEvtFlags, ticks.count());
+        }
+
+        /// Checks the wait condition of a task and sets the result of the co_await.
+        static bool isReady(Promise& promise, rtos::TickTimePoint now)
+        {
+            const bool timedOut = !promise.waitTicks.isWaitForever() && ((now - promise.waitStart) >= promise.waitTicks);
+
+            switch (promise.waitKind)
+            {
+                case WaitKind::Ready:
+                    return true;
+
+                case WaitKind::Delay:
+                    if (!timedOut)
+                    {
+                        return false;
+                    }
+                    break;
+
+                case WaitKind::EventFlags:
+                    promise.status = tx_event_flags_get(promise.flagsGroup, promise.requestedFlags, promise.getOption, promise.actualFlags, TX_NO_WAIT);
+                    if (promise.status != TX_SUCCESS && !timedOut)
+                    {
+                        return false;
+                    }
+                    break;
+
+                case WaitKind::Semaphore:
+                    promise.status = tx_semaphore_get(promise.sem, TX_NO_WAIT);
+                    if (promise.status != TX_SUCCESS && !timedOut)
+                    {
+                        return false;
+                    }
+                    break;
+            }
+
+            promise.waitKind = WaitKind::Ready;
+            return true;
+        }
+
+        Task::Handle tasks_[frameBlockCount] = {};
+        TX_EVENT_FLAGS_GROUP* evtFlags_ = nullptr;
+        ULONG evtFlag_ = 0;
+    };
+
+
+    inline void detail::onEventFlagsSet(TX_EVENT_FLAGS_GROUP* group)
+    {
+        // Setting the own wake-up flag would call this callback again.
+        if (notifiedScheduler != nullptr && !notifiedScheduler->isWakeUpGroup(group))
+        {
+            notifiedScheduler->wakeUp();
+        }
+    }
+
+    inline void detail::onSemaphorePut(TX_SEMAPHORE __attribute__((unused)) * sem)
+    {
+        if (notifiedScheduler != nullptr)
+        {
+            notifiedScheduler->wakeUp();
+        }
+    }
+
+} // namespace coro
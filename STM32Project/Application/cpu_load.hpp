@@ -0,0 +1,96 @@
+/// ====================================================================================================================
+/// \file       cpu_load.hpp
+/// \brief      Header-only measurement of the idle time of the CPU, the base of the load of the clock governor.
+/// \details    With TX_ENABLE_EXECUTION_CHANGE_NOTIFY, the ThreadX scheduler calls _tx_execution_thread_enter() each
+///             time a thread is switched in and _tx_execution_thread_exit() each time a thread is switched out.
+///             The meter accumulates the time in which the idle thread or no thread at all runs. The load of a
+///             measurement window is (window - idle time) / window. So all threads count as busy, not only one.
+///             - The idle thread is the lowest priority thread, which only uses free processing time (Background).
+///             - Interrupts count to the thread they preempt: The Cortex-M port does not call the ISR hooks for
+///               every interrupt, so interrupts preempting the idle thread count as idle.
+///             Usage:
+///                 IdleTimeMeter<CycleCounter> idleTimeMeter;
+///                 idleTimeMeter.setIdleThread(&thrdHdl_Background);                                // At init.
+///                 extern "C" void _tx_execution_thread_enter() { idleTimeMeter.threadEnter(tx_thread_identify()); }
+///                 extern "C" void _tx_execution_thread_exit() { idleTimeMeter.threadExit(); }
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include "tx_api.h"
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Accumulates the idle time of the CPU.
+/// \details  Template parameter Clock must provide a static 'uint32_t now()' function as time stamp source
+///           (e.g. CycleCounter). The idle time wraps around like the clock: calculate the idle time of a window
+///           always with unsigned subtraction of two idleTime() values.
+/// --------------------------------------------------------------------------------------------------------------------
+template <typename Clock>
+class IdleTimeMeter
+{
+public:
+    /// Sets the thread, whose execution time counts as idle time.
+    void setIdleThread(const TX_THREAD* thread)
+    {
+        idleThread_ = thread;
+    }
+
+    /// Call this in _tx_execution_thread_enter() with the thread, which is switched in.
+    void threadEnter(const TX_THREAD* thread)
+    {
+        setIdle(thread == idleThread_);
+    }
+
+    /// Call this in _tx_execution_thread_exit(). Until the next threadEnter() no thread runs, this is idle time.
+    void threadExit()
+    {
+        setIdle(true);
+    }
+
+    /// Returns the accumulated idle time in clock units (including the current idle period).
+    uint32_t idleTime() const
+    {
+        UINT oldPosture = tx_interrupt_control(TX_INT_DISABLE);
+        uint32_t idleTime = idleTime_;
+        if (idle_)
+        {
+            idleTime += Clock::now() - idleStart_;
+        }
+        tx_interrupt_control(oldPosture);
+        return idleTime;
+    }
+
+private:
+    /// Starts or ends an idle period. The scheduler calls the hooks with disabled interrupts.
+    void setIdle(bool idle)
+    {
+        if (idle == idle_)
+        {
+            return;
+        }
+        const uint32_t now = Clock::now();
+        if (idle)
+        {
+            idleStart_ = now;
+        }
+        else
+        {
+            idleTime_ += now - idleStart_;
+        }
+        idle_ = idle;
+    }
+
+    const TX_THREAD* idleThread_ = nullptr;
+    bool idle_ = false; // The initialization before the scheduler start counts as busy.
+    uint32_t idleStart_ = 0;
+    uint32_t idleTime_ = 0;
+};
@@ -0,0 +1,112 @@
+/// ====================================================================================================================
+/// \file       crc32.hpp
+/// \brief      Header-only software CRC-32 (IEEE 802.3 / zlib) with the slice-by-8 algorithm.
+/// \details    The slice-by-8 algorithm processes 8 bytes per iteration with 8 lookup tables (8 KB in flash).
+///             The tables are generated at compile time.
+///             The running CRC starts with crc32Init. The final CRC is (running CRC ^ crc32FinalXor).
+///             Same interface as Crc32Hardware (crc32_hw.hpp), so both can be used by the IntegrityScanner.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+//======================================================================================================================
+// MARK: Constants
+//======================================================================================================================
+constexpr uint32_t crc32Polynomial = 0xEDB88320; // Reflected polynomial 0x04C11DB7.
+constexpr uint32_t crc32Init = 0xFFFFFFFF;
+constexpr uint32_t crc32FinalXor = 0xFFFFFFFF;
+
+
+/// Lookup tables of the slice-by-8 algorithm.
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+
+//======================================================================================================================
+// MARK: Helper
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Generates the lookup tables at compile time.
+/// \details  Table n processes a byte, which is followed by n further bytes.
+/// --------------------------------------------------------------------------------------------------------------------
+constexpr Crc32Tables makeCrc32Tables()
+{
+    Crc32Tables tables = {};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? crc32Polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (std::size_t n = 1; n < 8; n++)
+    {
+        for (std::size_t i = 0; i < 256; i++)
+        {
+            tables[n][i] = (tables[n - 1][i] >> 8) ^ tables[0][tables[n - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Software CRC-32 engine (slice-by-8).
+/// --------------------------------------------------------------------------------------------------------------------
+struct Crc32Software
+{
+    static constexpr Crc32Tables tables = makeCrc32Tables();
+
+    /// Does nothing. Only needed for the same interface as Crc32Hardware.
+    static void init()
+    {
+    }
+
+    /// Continues the running CRC with the given data and returns the new running CRC.
+    static uint32_t update(uint32_t crc, const uint8_t* data, std::size_t size)
+    {
+        // 8 bytes per iteration (little endian):
+        while (size >= 8)
+        {
+            uint32_t one = 0;
+            uint32_t two = 0;
+            std::memcpy(&one, data, 4);
+            std::memcpy(&two, data + 4, 4);
+            one ^= crc;
+            crc = tables[7][one & 0xFF] ^ tables[6][(one >> 8) & 0xFF] ^ tables[5][(one >> 16) & 0xFF] ^ tables[4][one >> 24]
+                ^ tables[3][two & 0xFF] ^ tables[2][(two >> 8) & 0xFF] ^ tables[1][(two >> 16) & 0xFF] ^ tables[0][two >> 24];
+            data += 8;
+            size -= 8;
+        }
+
+        // Remaining bytes:
+        while (size > 0)
+        {
+            crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+            data++;
+            size--;
+        }
+        return crc;
+    }
+
+    /// Returns the final CRC-32 of the given data.
+    static uint32_t calculate(const void* data, std::size_t size)
+    {
+        return update(crc32Init, static_cast<const uint8_t*>(data), size) ^ crc32FinalXor;
+    }
+};
@@ -0,0 +1,71 @@
+/// ====================================================================================================================
+/// \file       crc32_hw.hpp
+/// \brief      CRC-32 (IEEE 802.3 / zlib) with the CRC peripheral of the STM32H7.
+/// \details    The peripheral is configured for the same results as Crc32Software (crc32.hpp):
+///             polynomial 0x04C11DB7, input bit reversal by byte, output bit reversal.
+///             The running CRC is kept outside of the peripheral. So every update() can continue another calculation.
+///             The words are fed byte swapped (__REV), because the peripheral processes a word MSB first.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "crc32.hpp" // Needed for crc32Init and crc32FinalXor.
+#include "main.h" // Includes the CMSIS device header with the CRC definitions.
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Hardware CRC-32 engine.
+/// --------------------------------------------------------------------------------------------------------------------
+struct Crc32Hardware
+{
+    /// Enables and configures the CRC peripheral. Call this once before using update().
+    static void init()
+    {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        CRC->POL = 0x04C11DB7;
+        CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT; // 32 bit polynomial, bit reversal by byte.
+    }
+
+    /// Continues the running CRC with the given data and returns the new running CRC.
+    static uint32_t update(uint32_t crc, const uint8_t* data, std::size_t size)
+    {
+        // Load the running CRC (the peripheral register holds it not reversed):
+        CRC->INIT = __RBIT(crc);
+        CRC->CR |= CRC_CR_RESET;
+
+        // 4 bytes per write:
+        while (size >= 4)
+        {
+            uint32_t word = 0;
+            std::memcpy(&word, data, 4);
+            CRC->DR = __REV(word);
+            data += 4;
+            size -= 4;
+        }
+
+        // Remaining bytes:
+        while (size > 0)
+        {
+            *reinterpret_cast<volatile uint8_t*>(&CRC->DR) = *data;
+            data++;
+            size--;
+        }
+        return CRC->DR;
+    }
+
+    /// Returns the final CRC-32 of the given data.
+    static uint32_t calculate(const void* data, std::size_t size)
+    {
+        return update(crc32Init, static_cast<const uint8_t*>(data), size) ^ crc32FinalXor;
+    }
+};
@@ -0,0 +1,36 @@
+/// ====================================================================================================================
+/// \file       cycle_counter.hpp
+/// \brief      Access to the DWT cycle counter of the Cortex-M7.
+/// \details    The counter runs with the CPU clock and wraps around after 2^32 cycles (approx. 8.9 s at 480 MHz).
+///             Calculate durations always with unsigned subtraction: (CycleCounter::now() - start).
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include "main.h" // Includes the CMSIS core header with the DWT and CoreDebug definitions.
+
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Cycle counter as time stamp source (e.g. for latency measurements).
+/// --------------------------------------------------------------------------------------------------------------------
+struct CycleCounter
+{
+    /// Enables the cycle counter. Call this once before using now().
+    static void init()
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Enable the trace and debug blocks (DWT).
+        DWT->LAR = 0xC5ACCE55;                          // Unlock the DWT registers (needed on Cortex-M7).
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    /// Returns the current value of the cycle counter.
+    static uint32_t now()
+    {
+        return DWT->CYCCNT;
+    }
+};
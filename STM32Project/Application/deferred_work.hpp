@@ -0,0 +1,242 @@
+/// ====================================================================================================================
+/// \file       deferred_work.hpp
+/// \brief      Header-only lock-free multi-producer / single-consumer queue to defer work from interrupts to a thread.
+/// \details    Interrupt service routines (or threads) post small work items into a bounded ring buffer.
+///             A work item consists of a function pointer and an inline payload of max. [payloadSize] bytes.
+///             The worker thread executes the items in the order of posting.
+///             - The queue is lock-free: producers reserve a cell with a compare-and-swap on the enqueue position
+///               (LDREX/STREX on Cortex-M7), so nested interrupts can post without disabling interrupts.
+///             - The worker arms a wake-up request before it waits. Only the first producer, which finds the request
+///               armed, sets the event flag. So a burst of items results in one wake-up of the worker thread
+///               instead of one per item.
+///             - Statistics for live watch: current and max. depth, overflows and a histogram of the latency
+///               between post() and the start of the execution. The depth is the distance between enqueue and
+///               dequeue position, so it counts reserved cells too and never exceeds [capacity].
+///             Usage:
+///                 DeferredWorkQueue<CycleCounter> deferredWork;
+///                 deferredWork.init(&evtFlags_Deferred, evtFlag_Deferred_WakeUp);  // In App_ThreadX_Init().
+///                 deferredWork.post(&workFct_Xyz, payload);                         // In the ISR.
+///                 deferredWork.runWorker();                                         // In the worker thread function.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "tx_api.h"
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Deferred work queue with a worker loop.
+/// \details  Template parameter Clock must provide a static 'uint32_t now()' function as time stamp source for the
+///           latency histogram (e.g. CycleCounter). Bin n of the histogram counts latencies in [2^(n-1), 2^n) clock
+///           units, bin 0 counts zero latencies and the last bin collects all larger values.
+/// --------------------------------------------------------------------------------------------------------------------
+template <typename Clock>
+class DeferredWorkQueue
+{
+public:
+    static constexpr std::size_t capacity = 32;      // Configure here the max. number of pending work items (power of 2).
+    static constexpr std::size_t payloadSize = 16;   // Configure here the max. size of the payload of a work item in bytes.
+    static constexpr std::size_t histogramBins = 24; // Configure here the number of bins of the latency histogram.
+
+    static_assert((capacity & (capacity - 1)) == 0, "The capacity must be a power of 2.");
+
+    /// Function type of a work item. The payload is only valid during the call.
+    using WorkFct = void (*)(const void* payload);
+
+    /// Creates the empty queue: cell n is free for the producer with enqueue position n.
+    DeferredWorkQueue()
+    {
+        for (std::size_t i = 0; i < capacity; i++)
+        {
+            cells_[i].sequence.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+        }
+    }
+
+    /// Sets the event flags group to wake up the worker thread. Items posted before are executed at worker start.
+    void init(TX_EVENT_FLAGS_GROUP* evtFlags, ULONG evtFlag)
+    {
+        evtFlag_ = evtFlag;
+        evtFlags_.store(evtFlags, std::memory_order_release);
+    }
+
+    /// Posts a work item with a copy of the payload. Returns false and counts an overflow, if the queue is full.
+    /// Can be called from interrupts and threads.
+    template <typename T>
+    bool post(WorkFct fct, const T& payload)
+    {
+        static_assert(sizeof(T) <= payloadSize, "The payload does not fit into a work item.");
+        static_assert(std::is_trivially_copyable_v<T>, "The payload must be trivially copyable.");
+        return postRaw(fct, &payload, sizeof(T));
+    }
+
+    /// Posts a work item without payload.
+    bool post(WorkFct fct)
+    {
+        return postRaw(fct, nullptr, 0);
+    }
+
+    /// Executes the work items. Call this in the thread function of the worker thread. Never returns.
+    [[noreturn]] void runWorker()
+    {
+        for (;;)
+        {
+            drain();
+
+            // Arm the wake-up request and check again, so an item published meanwhile is not missed.
+            // If the next cell is only reserved by a preempted producer, the producer sets the event flag after
+            // publishing it:
+            wakeUpRequested_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (isPublished(cells_[dequeuePos_.load(std::memory_order_relaxed) & (capacity - 1)]))
+            {
+                wakeUpRequested_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            // Wait for the next batch:
+            ULONG receivedEvtFlags = 0;
+            tx_event_flags_get(evtFlags_.load(std::memory_order_acquire), evtFlag_, TX_OR_CLEAR, &receivedEvtFlags, TX_WAIT_FOREVER);
+        }
+    }
+
+    /// Returns the number of pending work items (including cells reserved by a producer but not yet filled).
+    uint32_t depth() const
+    {
+        return enqueuePos_.load(std::memory_order_relaxed) - dequeuePos_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the max. number of pending work items since start.
+    uint32_t maxDepth() const
+    {
+        return maxDepth_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the number of work items which were dropped because the queue was full.
+    uint32_t overflows() const
+    {
+        return overflows_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the number of executed work items of the given latency histogram bin.
+    uint32_t latencyHistogram(std::size_t bin) const
+    {
+        return latencyHistogram_[bin];
+    }
+
+private:
+    /// One cell of the ring buffer. The sequence number tells producer and consumer who owns the cell.
+    struct Cell
+    {
+        std::atomic<uint32_t> sequence;
+        WorkFct fct;
+        uint32_t timestamp;
+        alignas(std::max_align_t) uint8_t payload[payloadSize];
+    };
+
+    bool postRaw(WorkFct fct, const void* payload, std::size_t size)
+    {
+        // Reserve a cell:
+        Cell* cell = nullptr;
+        uint32_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & (capacity - 1)];
+            const int32_t diff = static_cast<int32_t>(cell->sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Update the max. depth. The cell is not published yet, so the worker cannot pass it:
+        // The acquire load of the cell sequence above makes the dequeue position of its release visible, so
+        // the depth is max. [capacity].
+        const uint32_t depth = pos + 1 - dequeuePos_.load(std::memory_order_relaxed);
+        uint32_t oldMax = maxDepth_.load(std::memory_order_relaxed);
+        while (depth > oldMax && !maxDepth_.compare_exchange_weak(oldMax, depth, std::memory_order_relaxed))
+        {
+        }
+
+        // Fill and publish the cell:
+        cell->fct = fct;
+        cell->timestamp = Clock::now();
+        if (size > 0)
+        {
+            std::memcpy(&cell->payload[0], payload, size);
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        // Wake up the worker, if it has armed the wake-up request (first item of a batch):
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        TX_EVENT_FLAGS_GROUP* evtFlags = evtFlags_.load(std::memory_order_acquire);
+        if (evtFlags != nullptr && wakeUpRequested_.load(std::memory_order_relaxed) && wakeUpRequested_.exchange(false, std::memory_order_relaxed))
+        {
+            tx_event_flags_set(evtFlags, evtFlag_, TX_OR);
+        }
+        return true;
+    }
+
+    /// Returns true, if the producer has filled the cell at the current dequeue position.
+    bool isPublished(const Cell& cell) const
+    {
+        return static_cast<int32_t>(cell.sequence.load(std::memory_order_acquire) - (dequeuePos_.load(std::memory_order_relaxed) + 1)) >= 0;
+    }
+
+    /// Executes all published items in order.
+    void drain()
+    {
+        for (;;)
+        {
+            const uint32_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            Cell& cell = cells_[pos & (capacity - 1)];
+            if (!isPublished(cell))
+            {
+                return;
+            }
+
+            const uint32_t latency = Clock::now() - cell.timestamp;
+            const std::size_t bin = (latency == 0) ? 0 : static_cast<std::size_t>(32 - __builtin_clz(latency));
+            latencyHistogram_[(bin < histogramBins) ? bin : (histogramBins - 1)]++;
+
+            cell.fct(&cell.payload[0]);
+
+            // Release the cell for the producers (after the dequeue position, see postRaw()):
+            dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+            cell.sequence.store(pos + capacity, std::memory_order_release);
+        }
+    }
+
+    Cell cells_[capacity];
+    std::atomic<uint32_t> enqueuePos_{0};
+    std::atomic<uint32_t> dequeuePos_{0}; // Written by the worker only.
+    std::atomic<bool> wakeUpRequested_{false};
+    std::atomic<uint32_t> maxDepth_{0};
+    std::atomic<uint32_t> overflows_{0};
+    uint32_t latencyHistogram_[histogramBins] = {};
+    std::atomic<TX_EVENT_FLAGS_GROUP*> evtFlags_{nullptr};
+    ULONG evtFlag_ = 0;
+};
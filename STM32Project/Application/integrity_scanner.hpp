@@ -0,0 +1,173 @@
+/// ====================================================================================================================
+/// \file       integrity_scanner.hpp
+/// \brief      Header-only incremental CRC-32 integrity scanner for memory regions (e.g. firmware image, static RAM).
+/// \details    The scanner checksums the registered regions one after another in bounded slices. So it can run in
+///             idle time: each call of step() processes max. [sliceBytes] bytes and returns.
+///             The first complete CRC of a region is stored as reference, unless a reference is given at
+///             registration. Every later pass compares against it and counts a mismatch on difference.
+///             Template parameter Crc is the CRC engine: Crc32Software (crc32.hpp) or Crc32Hardware (crc32_hw.hpp).
+///             Template parameter Clock is the time stamp source for the pass duration. A pass is often shorter than
+///             one ThreadX tick, so use a cycle counter (e.g. clockScaling::FixedRateCycleCounter). So the scanner
+///             depends neither on HAL nor on ThreadX and can be tested on a host.
+///             Usage:
+///                 IntegrityScanner<Crc32Hardware, clockScaling::FixedRateCycleCounter> scanner;
+///                 scanner.addRegion(start, size);
+///                 scanner.step(1024); // Call this in the idle loop.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstddef>
+#include <cstdint>
+#include "crc32.hpp"
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Incremental integrity scanner.
+/// \details  Statistics for live watch: completed passes, mismatches, scanned bytes and the duration of the last pass.
+///           Clock must provide a static 'uint32_t now()' function and its frequency 'static constexpr uint32_t
+///           frequencyHz'. A pass must be shorter than the wrap-around of the clock.
+/// --------------------------------------------------------------------------------------------------------------------
+template <typename Crc, typename Clock, std::size_t MaxRegions = 4>
+class IntegrityScanner
+{
+public:
+    /// One memory region to check.
+    struct Region
+    {
+        const uint8_t* start = nullptr;
+        std::size_t size = 0;
+        uint32_t referenceCrc = 0;
+        bool hasReference = false;
+        uint32_t mismatches = 0;
+    };
+
+    /// Registers a region. The reference CRC is taken from the first pass. Returns false, if no slot is free.
+    bool addRegion(const void* start, std::size_t size)
+    {
+        if (regionCount_ >= MaxRegions)
+        {
+            return false;
+        }
+        regions_[regionCount_] = Region{static_cast<const uint8_t*>(start), size, 0, false, 0};
+        regionCount_++;
+        return true;
+    }
+
+    /// Registers a region with a known reference CRC (e.g. calculated by a post-build step).
+    bool addRegion(const void* start, std::size_t size, uint32_t referenceCrc)
+    {
+        if (!addRegion(start, size))
+        {
+            return false;
+        }
+        regions_[regionCount_ - 1].referenceCrc = referenceCrc;
+        regions_[regionCount_ - 1].hasReference = true;
+        return true;
+    }
+
+    /// Processes the next slice of max. sliceBytes bytes.
+    void step(std::size_t sliceBytes)
+    {
+        if (regionCount_ == 0)
+        {
+            return;
+        }
+        if (passBytes_ == 0 && regionOffset_ == 0 && regionIndex_ == 0)
+        {
+            passStart_ = Clock::now();
+        }
+
+        Region& region = regions_[regionIndex_];
+        const std::size_t remaining = region.size - regionOffset_;
+        const std::size_t size = (remaining < sliceBytes) ? remaining : sliceBytes;
+        crc_ = Crc::update(crc_, region.start + regionOffset_, size);
+        regionOffset_ += size;
+        passBytes_ += size;
+        bytesScanned_ += size;
+
+        if (regionOffset_ < region.size)
+        {
+            return;
+        }
+
+        // Region done: compare or learn the reference CRC:
+        const uint32_t result = crc_ ^ crc32FinalXor;
+        if (!region.hasReference)
+        {
+            region.referenceCrc = result;
+            region.hasReference = true;
+        }
+        else if (result != region.referenceCrc)
+        {
+            region.mismatches++;
+            mismatches_++;
+        }
+        crc_ = crc32Init;
+        regionOffset_ = 0;
+        regionIndex_++;
+
+        // Pass done:
+        if (regionIndex_ >= regionCount_)
+        {
+            regionIndex_ = 0;
+            passes_++;
+            lastPassBytes_ = passBytes_;
+            lastPassDuration_ = Clock::now() - passStart_;
+            passBytes_ = 0;
+        }
+    }
+
+    /// Returns the number of completed passes over all regions.
+    uint32_t passes() const
+    {
+        return passes_;
+    }
+
+    /// Returns the number of mismatches of all regions since start.
+    uint32_t mismatches() const
+    {
+        return mismatches_;
+    }
+
+    /// Returns the number of scanned bytes since start.
+    uint64_t bytesScanned() const
+    {
+        return bytesScanned_;
+    }
+
+    /// Returns the scan throughput of the last pass in bytes per second (0 until the first pass is done).
+    /// 64 bit, because a short pass measured with a cycle counter can exceed 2^32 bytes per second.
+    uint64_t throughputBytesPerSecond() const
+    {
+        const uint64_t duration = (lastPassDuration_ == 0) ? 1 : lastPassDuration_;
+        return (passes_ == 0) ? 0 : (lastPassBytes_ * static_cast<uint64_t>(Clock::frequencyHz)) / duration;
+    }
+
+    /// Returns the region with the given index.
+    const Region& region(std::size_t index) const
+    {
+        return regions_[index];
+    }
+
+private:
+    Region regions_[MaxRegions] = {};
+    std::size_t regionCount_ = 0;
+    std::size_t regionIndex_ = 0;
+    std::size_t regionOffset_ = 0;
+    uint32_t crc_ = crc32Init;
+    uint64_t passBytes_ = 0;
+    uint64_t lastPassBytes_ = 0;
+    uint64_t bytesScanned_ = 0;
+    uint32_t passes_ = 0;
+    uint32_t mismatches_ = 0;
+    uint32_t passStart_ = 0;
+    uint32_t lastPassDuration_ = 0; // In clock units.
+};
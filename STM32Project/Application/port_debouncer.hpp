@@ -0,0 +1,89 @@
+/// ====================================================================================================================
+/// \file       port_debouncer.hpp
+/// \brief      Header-only debouncer for all 16 inputs of a GPIO port at once.
+/// \details    The debouncer uses vertical counters: bit n of the two counter words cnt0/cnt1 form a 2-bit counter
+///             for pin n. So all 16 pins are debounced in parallel with a few bitwise operations per scan,
+///             independent of the number of inputs in use.
+///             A pin changes its debounced state after 4 consecutive scans with a level different from the
+///             current debounced state. Any scan that matches the debounced state resets the pin's counter.
+///             Usage:
+///                 PortDebouncer btns;
+///                 btns.scan(GPIOC);              // Call this periodically, e.g. every 5 ms.
+///                 if (btns.pressed() & Button1_Blue_Pin) { ... }
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+
+
+//======================================================================================================================
+// MARK: Class
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Debounces the 16 input bits of a GPIO port with vertical counters.
+/// \details  The edge masks pressed() and released() are valid until the next call of update() or scan().
+///           "Pressed" means the debounced bit changed from 0 to 1 (active high), "released" from 1 to 0.
+///           For active low inputs simply swap the meaning of both masks.
+/// --------------------------------------------------------------------------------------------------------------------
+class PortDebouncer
+{
+public:
+    /// Creates the debouncer with the given initial debounced state (e.g. the first IDR read).
+    constexpr explicit PortDebouncer(uint16_t initialState = 0) : state_(initialState)
+    {
+    }
+
+    /// Feeds one raw sample of all 16 pins into the debouncer and updates the edge masks.
+    constexpr void update(uint16_t sample)
+    {
+        const uint16_t delta = sample ^ state_; // Pins which differ from the debounced state.
+
+        // Count up the 2-bit counter of all pins in 'delta', clear the counter of all other pins:
+        cnt1_ = (cnt1_ ^ cnt0_) & delta;
+        cnt0_ = ~cnt0_ & delta;
+
+        // A counter overflowing from 3 to 0 while the pin still differs, toggles the debounced state:
+        const uint16_t toggle = delta & ~(cnt0_ | cnt1_);
+        state_ ^= toggle;
+
+        pressed_ = toggle & state_;
+        released_ = toggle & ~state_;
+    }
+
+    /// Reads the input data register of the port with a single load and feeds it into the debouncer.
+    template <typename Port>
+    void scan(const Port* port)
+    {
+        update(static_cast<uint16_t>(port->IDR));
+    }
+
+    /// Returns the debounced state of all 16 pins.
+    constexpr uint16_t state() const
+    {
+        return state_;
+    }
+
+    /// Returns the pins which changed from 0 to 1 with the last update.
+    constexpr uint16_t pressed() const
+    {
+        return pressed_;
+    }
+
+    /// Returns the pins which changed from 1 to 0 with the last update.
+    constexpr uint16_t released() const
+    {
+        return released_;
+    }
+
+private:
+    uint16_t state_ = 0;    ///< Debounced state of all pins.
+    uint16_t cnt0_ = 0;     ///< Bit 0 of the vertical counters.
+    uint16_t cnt1_ = 0;     ///< Bit 1 of the vertical counters.
+    uint16_t pressed_ = 0;  ///< Rising edges of the last update.
+    uint16_t released_ = 0; ///< Falling edges of the last update.
+};
@@ -0,0 +1,283 @@
+/// ====================================================================================================================
+/// \file       rtos_time.hpp
+/// \brief      Header-only strongly typed durations and time points based on the ThreadX tick.
+/// \details    In the style of std::chrono, but the conversions are done at compile time wherever possible:
+///             - The literals 10_ms, 2_s, 5_ticks are consteval. A duration, which does not fit into a ULONG tick
+///               count, is a compile error.
+///             - ceilTicks() converts any std::chrono::duration (rounding up). The conversion factor is reduced at
+///               compile time, so e.g. with TX_TIMER_TICKS_PER_SECOND = 1000 there is no runtime division at all.
+///             - Ticks::count() feeds the ThreadX services directly, e.g. tx_timer_create() or tx_event_flags_get().
+///             - Only ThreadX is needed (no HAL), so the header can be tested on a host.
+///             Usage:
+///                 using namespace rtos::literals;
+///                 constexpr rtos::Ticks period = 10_ms;
+///                 tx_timer_create(..., period.count(), period.count(), TX_AUTO_ACTIVATE);
+///                 rtos::Deadline deadline = rtos::Deadline::after(500_ms);
+///                 if (deadline.expired()) { ... }
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include "tx_api.h"
+
+
+namespace rtos
+{
+    //==================================================================================================================
+    // MARK: Helper
+    //==================================================================================================================
+
+    namespace detail
+    {
+        /// ------------------------------------------------------------------------------------------------------------
+        /// \brief      Called, if a duration does not fit into a tick count.
+        /// \details    This function is not constexpr on purpose: reaching it at compile time is a compile error.
+        /// ------------------------------------------------------------------------------------------------------------
+        inline void durationOutOfRange()
+        {
+            // TODO: Replace it with an error handling mechanism!
+            while (true)
+            {
+            };
+        }
+    } // namespace detail
+
+
+    //==================================================================================================================
+    // MARK: Ticks
+    //==================================================================================================================
+
+    /// Period of one ThreadX tick in seconds.
+    using TickPeriod = std::ratio<1, TX_TIMER_TICKS_PER_SECOND>;
+
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Duration in ThreadX ticks.
+    /// \details  The value TX_WAIT_FOREVER is reserved for waitForever() and is never the result of a conversion.
+    ///           The arithmetic saturates instead of wrapping around:
+    ///           - waitForever() stays waitForever() (plus or minus any finite duration),
+    ///           - a finite sum is limited to max(), so it can never become TX_WAIT_FOREVER by accident,
+    ///           - a difference is limited to zero().
+    /// ----------------------------------------------------------------------------------------------------------------
+    class Ticks
+    {
+    public:
+        using rep = ULONG;
+        using period = TickPeriod;
+
+        constexpr Ticks() = default;
+
+        constexpr explicit Ticks(ULONG count) : count_(count)
+        {
+        }
+
+        /// Returns the number of ticks as needed by the ThreadX services.
+        constexpr ULONG count() const
+        {
+            return count_;
+        }
+
+        static constexpr Ticks zero()
+        {
+            return Ticks(0);
+        }
+
+        /// Largest finite duration (TX_WAIT_FOREVER - 1).
+        static constexpr Ticks max()
+        {
+            return Ticks(TX_WAIT_FOREVER - 1);
+        }
+
+        /// Timeout value to wait without limit (TX_WAIT_FOREVER).
+        static constexpr Ticks waitForever()
+        {
+            return Ticks(TX_WAIT_FOREVER);
+        }
+
+        constexpr bool isWaitForever() const
+        {
+            return count_ == TX_WAIT_FOREVER;
+        }
+
+        constexpr Ticks operator+(Ticks other) const
+        {
+            if (isWaitForever() || other.isWaitForever())
+            {
+                return waitForever();
+            }
+            return (other.count_ > max().count_ - count_) ? max() : Ticks(count_ + other.count_);
+        }
+
+        constexpr Ticks operator-(Ticks other) const
+        {
+            if (isWaitForever() && !other.isWaitForever())
+            {
+                return waitForever();
+            }
+            return (other.count_ >= count_) ? zero() : Ticks(count_ - other.count_);
+        }
+
+        friend constexpr auto operator<=>(Ticks, Ticks) = default;
+
+    private:
+        ULONG count_ = 0;
+    };
+
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Converts a std::chrono::duration into ticks (rounding up, so a delay is never shorter).
+    /// \details  The factor Period / TickPeriod is reduced at compile time: if its denominator is 1, only a
+    ///           multiplication remains. A negative or too large duration calls detail::durationOutOfRange().
+    /// ----------------------------------------------------------------------------------------------------------------
+    template <typename Rep, typename Period>
+    constexpr Ticks ceilTicks(std::chrono::duration<Rep, Period> duration)
+    {
+        using Factor = std::ratio_divide<Period, TickPeriod>;
+        constexpr uint64_t maxTicks = static_cast<uint64_t>(TX_WAIT_FOREVER) - 1;
+
+        if constexpr (std::is_signed_v<Rep>)
+        {
+            if (duration.count() < 0)
+            {
+                detail::durationOutOfRange();
+            }
+        }
+        if (static_cast<uint64_t>(duration.count()) > (maxTicks * Factor::den) / Factor::num + 1)
+        {
+            detail::durationOutOfRange();
+        }
+        const uint64_t count = static_cast<uint64_t>(duration.count());
+
+        uint64_t ticks = count * Factor::num;
+        if constexpr (Factor::den != 1)
+        {
+            ticks = (ticks + Factor::den - 1) / Factor::den;
+        }
+        if (ticks > maxTicks)
+        {
+            detail::durationOutOfRange();
+        }
+        return Ticks(static_cast<ULONG>(ticks));
+    }
+
+
+    /// Converts a std::chrono::duration into ticks at compile time. Out of range durations are compile errors.
+    template <typename Rep, typename Period>
+    consteval Ticks toTicks(std::chrono::duration<Rep, Period> duration)
+    {
+        return ceilTicks(duration);
+    }
+
+
+    //==================================================================================================================
+    // MARK: Literals
+    //==================================================================================================================
+
+    namespace literals
+    {
+        consteval Ticks operator""_ticks(unsigned long long count)
+        {
+            return ceilTicks(std::chrono::duration<unsigned long long, TickPeriod>(count));
+        }
+
+        consteval Ticks operator""_us(unsigned long long micros)
+        {
+            return ceilTicks(std::chrono::duration<unsigned long long, std::micro>(micros));
+        }
+
+        consteval Ticks operator""_ms(unsigned long long millis)
+        {
+            return ceilTicks(std::chrono::duration<unsigned long long, std::milli>(millis));
+        }
+
+        consteval Ticks operator""_s(unsigned long long secs)
+        {
+            return ceilTicks(std::chrono::duration<unsigned long long>(secs));
+        }
+    } // namespace literals
+
+
+    //==================================================================================================================
+    // MARK: Time Points
+    //==================================================================================================================
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Point in time of the ThreadX tick counter (tx_time_get()).
+    /// \details  The difference of two time points is wrap-around safe, as long as it is shorter than the range of ULONG.
+    /// ----------------------------------------------------------------------------------------------------------------
+    class TickTimePoint
+    {
+    public:
+        constexpr TickTimePoint() = default;
+
+        constexpr explicit TickTimePoint(ULONG ticks) : ticks_(ticks)
+        {
+        }
+
+        static TickTimePoint now()
+        {
+            return TickTimePoint(tx_time_get());
+        }
+
+        constexpr ULONG ticks() const
+        {
+            return ticks_;
+        }
+
+        constexpr Ticks operator-(TickTimePoint earlier) const
+        {
+            return Ticks(ticks_ - earlier.ticks_);
+        }
+
+        constexpr TickTimePoint operator+(Ticks duration) const
+        {
+            return TickTimePoint(ticks_ + duration.count());
+        }
+
+    private:
+        ULONG ticks_ = 0;
+    };
+
+
+    /// ----------------------------------------------------------------------------------------------------------------
+    /// \brief    Deadline in ThreadX ticks.
+    /// ----------------------------------------------------------------------------------------------------------------
+    class Deadline
+    {
+    public:
+        /// Creates a deadline, which expires after the given duration from now.
+        static Deadline after(Ticks duration)
+        {
+            return Deadline(TickTimePoint::now(), duration);
+        }
+
+        constexpr Deadline(TickTimePoint start, Ticks duration) : start_(start), duration_(duration)
+        {
+        }
+
+        bool expired() const
+        {
+            return (TickTimePoint::now() - start_) >= duration_;
+        }
+
+        /// Returns the remaining ticks, e.g. as timeout for a ThreadX service. Zero, if the deadline is expired.
+        Ticks remaining() const
+        {
+            const Ticks elapsed = TickTimePoint::now() - start_;
+            return (elapsed >= duration_) ? Ticks::zero() : (duration_ - elapsed);
+        }
+
+    private:
+        TickTimePoint start_;
+        Ticks duration_;
+    };
+
+} // namespace rtos
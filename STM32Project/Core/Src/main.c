@@ -53,6 +53,7 @@
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+void App_TimebaseElapsed_Callback(TIM_HandleTypeDef *htim); // Implemented in Application/application.cpp.
 
 /* USER CODE END PFP */
 
@@ -198,6 +199,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  App_TimebaseElapsed_Callback(htim);
 
   /* USER CODE END Callback 1 */
 }
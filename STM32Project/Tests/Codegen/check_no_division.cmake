@@ -0,0 +1,45 @@
+#======================================================================================================================
+# Checks the assembler output of rtos_time_codegen.cpp:
+#======================================================================================================================
+# Usage: cmake -DASM_FILE=<file.s> -P check_no_division.cmake
+# The functions in WITH_DIVISION must contain a division instruction. The rest of the file must not.
+# The whole file is checked, because without optimization ceilTicks() is not inlined into msToTicks().
+set(CONVERSIONS msToTicks sToTicks)
+set(WITH_DIVISION runtimeMsToTicks)
+
+file(READ "${ASM_FILE}" ASM)
+
+# Division instructions of x86 (div, idiv), ARM (udiv, sdiv) and AArch64:
+set(DIVISION_REGEX "[ \t](u|s|i)?div[a-z]*[ \t]")
+
+# Returns the assembler lines between the label of the function and the end of the function.
+function(get_function_body NAME OUT_VAR)
+    string(FIND "${ASM}" "\n${NAME}:" START)
+    if(START EQUAL -1)
+        message(FATAL_ERROR "Function ${NAME} not found in ${ASM_FILE}.")
+    endif()
+    string(SUBSTRING "${ASM}" ${START} -1 BODY)
+    string(FIND "${BODY}" ".cfi_endproc" END)
+    string(SUBSTRING "${BODY}" 0 ${END} BODY)
+    set(${OUT_VAR} "${BODY}" PARENT_SCOPE)
+endfunction()
+
+foreach(NAME ${CONVERSIONS})
+    get_function_body(${NAME} BODY)
+endforeach()
+
+foreach(NAME ${WITH_DIVISION})
+    get_function_body(${NAME} BODY)
+    if(NOT BODY MATCHES "${DIVISION_REGEX}")
+        message(FATAL_ERROR "${NAME} contains no division, the check does not detect divisions:\n${BODY}")
+    endif()
+    message("${NAME}: division found (expected)")
+    string(REPLACE "${BODY}" "" ASM "${ASM}")
+endforeach()
+
+if(ASM MATCHES "${DIVISION_REGEX}")
+    string(REGEX MATCH "[^\n]*${DIVISION_REGEX}[^\n]*" LINE "${ASM}")
+    message(FATAL_ERROR "The conversions contain a runtime division: ${LINE}")
+endif()
+list(JOIN CONVERSIONS ", " CONVERSION_NAMES)
+message("${CONVERSION_NAMES}: no division")
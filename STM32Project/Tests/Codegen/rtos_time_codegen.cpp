@@ -0,0 +1,26 @@
+/// ====================================================================================================================
+/// \file       rtos_time_codegen.cpp
+/// \brief      Conversions compiled to assembler by the host build. check_no_division.cmake checks the functions.
+/// \details    msToTicks() and sToTicks() use rtos::ceilTicks(): with a 1 ms tick the conversion factor is reduced to
+///             an integer at compile time, so there must be no division instruction (even without optimization).
+///             runtimeMsToTicks() divides by a runtime value (like a conversion without compile time reduction)
+///             and must contain one. It proves that the check works.
+/// ====================================================================================================================
+#include <chrono>
+#include <cstdint>
+#include "rtos_time.hpp"
+
+extern "C" ULONG msToTicks(uint32_t millis)
+{
+    return rtos::ceilTicks(std::chrono::duration<uint32_t, std::milli>(millis)).count();
+}
+
+extern "C" ULONG sToTicks(uint32_t secs)
+{
+    return rtos::ceilTicks(std::chrono::duration<uint32_t>(secs)).count();
+}
+
+extern "C" ULONG runtimeMsToTicks(uint32_t millis, uint32_t millisPerTick)
+{
+    return (millis + millisPerTick - 1) / millisPerTick;
+}
@@ -0,0 +1,9 @@
+/// ====================================================================================================================
+/// \file       rtos_time_out_of_range.cpp
+/// \brief      Must NOT compile: a literal, which does not fit into a ULONG tick count, is a compile error.
+/// ====================================================================================================================
+#include "rtos_time.hpp"
+
+using namespace rtos::literals;
+
+constexpr rtos::Ticks tooLong = 5000000000_ms;
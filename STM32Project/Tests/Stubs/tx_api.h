@@ -0,0 +1,231 @@
+/// ====================================================================================================================
+/// \file       tx_api.h
+/// \brief      Host stand-in for the ThreadX API, only as much as the header-only application parts need.
+/// \details    The types have the sizes of the Cortex-M port (ULONG is 32 bit), so wrap-around behaves like on target.
+///             The tick counter is simulated: tests set or advance hostTx::ticks explicitly.
+///             Blocking services:
+///             - tx_thread_sleep() and a tx_event_flags_get() with a finite timeout, which is not satisfied, do not
+///               block. They advance the simulated tick by the timeout (single-threaded simulation).
+///               If a sleep exceeds the remaining hostTx::sleepBudget, it throws hostTx::Stop to end a never
+///               returning loop.
+///             - tx_event_flags_get() with TX_WAIT_FOREVER blocks until another std::thread sets the flags.
+///             tx_interrupt_control() does nothing: code which relies on it must only run in one std::thread.
+///             The notify callbacks of event flags groups and semaphores are called like in ThreadX: after the
+///             flags are set or the instance is put, in the context of the caller.
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+
+//======================================================================================================================
+// MARK: Types and Constants
+//======================================================================================================================
+typedef void VOID;
+typedef char CHAR;
+typedef unsigned int UINT;
+typedef uint32_t ULONG;
+
+#define TX_SUCCESS 0x00
+#define TX_NO_EVENTS 0x07
+#define TX_NO_INSTANCE 0x0D
+#define TX_WAIT_FOREVER ((ULONG)0xFFFFFFFFUL)
+#define TX_NO_WAIT ((ULONG)0)
+#define TX_OR 0
+#define TX_OR_CLEAR 1
+#define TX_AND 2
+#define TX_AND_CLEAR 3
+#define TX_INT_DISABLE 1
+#define TX_INT_ENABLE 0
+
+#ifndef TX_TIMER_TICKS_PER_SECOND
+#define TX_TIMER_TICKS_PER_SECOND 1000
+#endif
+
+struct TX_EVENT_FLAGS_GROUP
+{
+    ULONG tx_event_flags_group_current = 0;
+    UINT tx_event_flags_group_suspended_count = 0; // Number of threads waiting with TX_WAIT_FOREVER.
+    VOID (*tx_event_flags_group_set_notify)(TX_EVENT_FLAGS_GROUP* group_ptr) = nullptr;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+struct TX_SEMAPHORE
+{
+    std::atomic<ULONG> tx_semaphore_count{0};
+    VOID (*tx_semaphore_put_notify)(TX_SEMAPHORE* semaphore_ptr) = nullptr;
+};
+
+struct TX_THREAD
+{
+    ULONG tx_thread_id = 0;
+};
+
+
+//======================================================================================================================
+// MARK: Simulation
+//======================================================================================================================
+namespace hostTx
+{
+    /// Simulated ThreadX tick counter.
+    inline std::atomic<ULONG> ticks{0};
+
+    /// Number of calls of tx_thread_sleep() and of waits with a finite timeout, which advanced the tick.
+    inline std::atomic<uint32_t> sleeps{0};
+
+    /// Number of calls of tx_event_flags_set() (e.g. wake-ups of a worker thread).
+    inline std::atomic<uint32_t> eventFlagSets{0};
+
+    /// Remaining ticks, which may be slept. See class Stop.
+    inline uint64_t sleepBudget = UINT64_MAX;
+
+    /// Thrown by a sleep, which exceeds the remaining sleepBudget.
+    struct Stop
+    {
+    };
+
+    /// Advances the simulated tick by a sleep.
+    inline void sleep(ULONG sleepTicks)
+    {
+        if (sleepTicks > sleepBudget)
+        {
+            throw Stop{};
+        }
+        sleepBudget -= sleepTicks;
+        ticks += sleepTicks;
+        sleeps++;
+    }
+} // namespace hostTx
+
+
+//======================================================================================================================
+// MARK: Services
+//======================================================================================================================
+inline ULONG tx_time_get()
+{
+    return hostTx::ticks.load();
+}
+
+inline UINT tx_thread_sleep(ULONG timer_ticks)
+{
+    hostTx::sleep(timer_ticks);
+    return TX_SUCCESS;
+}
+
+inline UINT tx_interrupt_control(UINT new_posture)
+{
+    return new_posture == TX_INT_DISABLE ? TX_INT_ENABLE : TX_INT_DISABLE;
+}
+
+inline UINT tx_event_flags_create(TX_EVENT_FLAGS_GROUP* group_ptr, CHAR*)
+{
+    std::lock_guard<std::mutex> lock(group_ptr->mutex);
+    group_ptr->tx_event_flags_group_current = 0;
+    return TX_SUCCESS;
+}
+
+inline UINT tx_event_flags_set(TX_EVENT_FLAGS_GROUP* group_ptr, ULONG flags_to_set, UINT set_option)
+{
+    VOID (*notify)(TX_EVENT_FLAGS_GROUP*) = nullptr;
+    hostTx::eventFlagSets++;
+    {
+        std::lock_guard<std::mutex> lock(group_ptr->mutex);
+        if (set_option == TX_OR)
+        {
+            group_ptr->tx_event_flags_group_current |= flags_to_set;
+        }
+        else
+        {
+            group_ptr->tx_event_flags_group_current &= flags_to_set;
+        }
+        group_ptr->changed.notify_all();
+        notify = group_ptr->tx_event_flags_group_set_notify;
+    }
+    if (notify != nullptr)
+    {
+        notify(group_ptr);
+    }
+    return TX_SUCCESS;
+}
+
+inline UINT tx_event_flags_set_notify(TX_EVENT_FLAGS_GROUP* group_ptr, VOID (*events_set_notify)(TX_EVENT_FLAGS_GROUP*))
+{
+    std::lock_guard<std::mutex> lock(group_ptr->mutex);
+    group_ptr->tx_event_flags_group_set_notify = events_set_notify;
+    return TX_SUCCESS;
+}
+
+inline UINT tx_event_flags_get(TX_EVENT_FLAGS_GROUP* group_ptr, ULONG requested_flags, UINT get_option, ULONG* actual_flags_ptr, ULONG wait_option)
+{
+    std::unique_lock<std::mutex> lock(group_ptr->mutex);
+    auto satisfied = [&]() {
+        const ULONG current = group_ptr->tx_event_flags_group_current;
+        return (get_option & TX_AND) ? ((current & requested_flags) == requested_flags) : ((current & requested_flags) != 0);
+    };
+
+    if (!satisfied())
+    {
+        if (wait_option != TX_WAIT_FOREVER)
+        {
+            lock.unlock();
+            if (wait_option != TX_NO_WAIT)
+            {
+                hostTx::sleep(wait_option);
+            }
+            return TX_NO_EVENTS;
+        }
+        group_ptr->tx_event_flags_group_suspended_count++;
+        group_ptr->changed.wait(lock, satisfied);
+        group_ptr->tx_event_flags_group_suspended_count--;
+    }
+
+    *actual_flags_ptr = group_ptr->tx_event_flags_group_current;
+    if (get_option & TX_OR_CLEAR)
+    {
+        group_ptr->tx_event_flags_group_current &= ~requested_flags;
+    }
+    return TX_SUCCESS;
+}
+
+inline UINT tx_semaphore_create(TX_SEMAPHORE* semaphore_ptr, CHAR*, ULONG initial_count)
+{
+    semaphore_ptr->tx_semaphore_count = initial_count;
+    return TX_SUCCESS;
+}
+
+inline UINT tx_semaphore_get(TX_SEMAPHORE* semaphore_ptr, ULONG)
+{
+    ULONG count = semaphore_ptr->tx_semaphore_count.load();
+    while (count != 0)
+    {
+        if (semaphore_ptr->tx_semaphore_count.compare_exchange_weak(count, count - 1))
+        {
+            return TX_SUCCESS;
+        }
+    }
+    return TX_NO_INSTANCE;
+}
+
+inline UINT tx_semaphore_put(TX_SEMAPHORE* semaphore_ptr)
+{
+    semaphore_ptr->tx_semaphore_count++;
+    if (semaphore_ptr->tx_semaphore_put_notify != nullptr)
+    {
+        semaphore_ptr->tx_semaphore_put_notify(semaphore_ptr);
+    }
+    return TX_SUCCESS;
+}
+
+inline UINT tx_semaphore_put_notify(TX_SEMAPHORE* semaphore_ptr, VOID (*semaphore_put_notify)(TX_SEMAPHORE*))
+{
+    semaphore_ptr->tx_semaphore_put_notify = semaphore_put_notify;
+    return TX_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/// ====================================================================================================================
+/// \file       bench_coro_scheduler.cpp
+/// \brief      Host benchmark: memory per coroutine task and task switch cost compared with a thread switch.
+/// \details    - Memory: the frame size requested by a typical task (coroTask_Demo in application.cpp is the same
+///               loop) and the arena block it occupies, compared with the minimum stack of a ThreadX thread.
+///             - Switch cost: [taskCount] tasks co_await coro::yield() in a loop. One switch is one resume plus the
+///               suspension at the next co_await, including the poll of the scheduler.
+///               As stand-in for a tx_thread context switch, two host threads hand over a token with semaphores.
+///               A host OS switch is far more expensive than a ThreadX context switch on the Cortex-M7. So use the
+///               numbers only as a ratio and measure both on target with CycleCounter before moving a thread.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include <cstdio>
+#include <semaphore>
+#include <thread>
+#include "coro_scheduler.hpp"
+#include "test_common.hpp"
+
+using namespace rtos::literals;
+
+
+//======================================================================================================================
+// MARK: Tasks
+//======================================================================================================================
+
+/// Same loop as coroTask_Demo() in application.cpp.
+static coro::Task delayTask(uint32_t* counter)
+{
+    for (;;)
+    {
+        co_await coro::delay(100_ms);
+        (*counter)++;
+    }
+}
+
+
+/// Yields [switches] times and ends.
+static coro::Task yieldTask(uint32_t switches, uint32_t* counter)
+{
+    for (uint32_t i = 0; i < switches; i++)
+    {
+        co_await coro::yield();
+        (*counter)++;
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Benchmarks
+//======================================================================================================================
+
+/// Prints the memory needed per task.
+static void benchMemory()
+{
+    uint32_t counter = 0;
+    coro::Scheduler scheduler;
+    scheduler.spawn(delayTask(&counter));
+
+    constexpr std::size_t minThreadStack = 1024; // TX_MINIMUM_STACK in STM32Project.ioc.
+    std::printf("Coroutine task:  frame %zu bytes, arena block %zu bytes, scheduler slot %zu bytes\n",
+                coro::frameArena.maxFrameSize(), coro::frameBlockSize, sizeof(coro::Task::Handle));
+    std::printf("ThreadX thread:  stack >= %zu bytes (TX_MINIMUM_STACK) + TX_THREAD control block\n", minThreadStack);
+}
+
+
+/// Returns the cost of one coroutine task switch.
+static double benchCoroutineSwitch()
+{
+    constexpr uint32_t taskCount = 4;
+    constexpr uint32_t switchesPerTask = 1000000;
+
+    hostTx::ticks = 0;
+    hostTx::sleepBudget = 0; // The first sleep (all tasks done) ends run().
+    uint32_t counter = 0;
+    coro::Scheduler scheduler;
+    for (uint32_t i = 0; i < taskCount; i++)
+    {
+        scheduler.spawn(yieldTask(switchesPerTask, &counter));
+    }
+
+    const uint64_t start = benchNow();
+    try
+    {
+        scheduler.run();
+    }
+    catch (const hostTx::Stop&)
+    {
+    }
+    const uint64_t time = benchNow() - start;
+
+    if (counter != taskCount * switchesPerTask)
+    {
+        std::printf("FAILED: %u of %u switches\n", counter, taskCount * switchesPerTask);
+        return -1.0;
+    }
+    return static_cast<double>(time) / counter;
+}
+
+
+/// Returns the cost of one host thread switch (token passed between two threads).
+static double benchThreadSwitch()
+{
+    constexpr uint32_t roundTrips = 50000;
+    std::binary_semaphore ping(0);
+    std::binary_semaphore pong(0);
+
+    std::thread partner([&]() {
+        for (uint32_t i = 0; i < roundTrips; i++)
+        {
+            ping.acquire();
+            pong.release();
+        }
+    });
+
+    const uint64_t start = benchNow();
+    for (uint32_t i = 0; i < roundTrips; i++)
+    {
+        ping.release();
+        pong.acquire();
+    }
+    const uint64_t time = benchNow() - start;
+    partner.join();
+    return static_cast<double>(time) / (2.0 * roundTrips);
+}
+
+
+int main()
+{
+    benchMemory();
+
+    const double coroutineSwitch = benchCoroutineSwitch();
+    const double threadSwitch = benchThreadSwitch();
+    std::printf("Coroutine task switch:   %10.1f %s\n", coroutineSwitch, benchUnit());
+    std::printf("Host thread switch:      %10.1f %s (stand-in for tx_thread)\n", threadSwitch, benchUnit());
+    return (coroutineSwitch < 0.0) ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+/// ====================================================================================================================
+/// \file       bench_crc32.cpp
+/// \brief      Host benchmark: slice-by-8 CRC-32 (Crc32Software) compared with the bytewise table-driven CRC-32.
+/// \details    Both run over a buffer of the size of a scanner slice and of a larger block. The bytewise variant uses
+///             the first table of Crc32Software (1 KB instead of 8 KB). On target, measure both with CycleCounter:
+///             the result depends on the flash wait states and the cache.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "crc32.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Reference
+//======================================================================================================================
+
+/// Bytewise table-driven CRC-32.
+static uint32_t bytewiseCrc32(const uint8_t* data, std::size_t size)
+{
+    uint32_t crc = crc32Init;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        crc = (crc >> 8) ^ Crc32Software::tables[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc ^ crc32FinalXor;
+}
+
+
+//======================================================================================================================
+// MARK: Benchmarks
+//======================================================================================================================
+
+/// Returns the cost per byte of the given CRC function.
+template <typename Fct>
+static double benchPerByte(Fct fct, const std::vector<uint8_t>& data, std::size_t size, uint32_t& result)
+{
+    const std::size_t rounds = (64 * 1024 * 1024) / size;
+    uint32_t crc = 0;
+    const uint64_t start = benchNow();
+    for (std::size_t round = 0; round < rounds; round++)
+    {
+        crc ^= fct(&data[round % 8], size);
+        benchKeep(crc);
+    }
+    const uint64_t time = benchNow() - start;
+    result = crc;
+    return static_cast<double>(time) / static_cast<double>(rounds * size);
+}
+
+
+int main()
+{
+    std::vector<uint8_t> data(64 * 1024 + 8);
+    uint32_t value = 0x12345678;
+    for (uint8_t& byte : data)
+    {
+        value = value * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(value >> 24);
+    }
+
+    bool agree = true;
+    for (std::size_t size : {std::size_t{1024}, std::size_t{64 * 1024}})
+    {
+        uint32_t sliceBy8Result = 0;
+        uint32_t bytewiseResult = 0;
+        const double sliceBy8 = benchPerByte(&Crc32Software::calculate, data, size, sliceBy8Result);
+        const double bytewise = benchPerByte([](const void* d, std::size_t s) { return bytewiseCrc32(static_cast<const uint8_t*>(d), s); }, data, size, bytewiseResult);
+        agree = agree && (sliceBy8Result == bytewiseResult);
+        std::printf("%6zu bytes: slice-by-8 %6.3f %s/byte, bytewise %6.3f %s/byte, speed-up %.1fx\n",
+                    size, sliceBy8, benchUnit(), bytewise, benchUnit(), bytewise / sliceBy8);
+    }
+
+    if (!agree)
+    {
+        std::printf("FAILED: slice-by-8 and bytewise CRC differ\n");
+        return 1;
+    }
+    return 0;
+}
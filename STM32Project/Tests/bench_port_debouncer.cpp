@@ -0,0 +1,122 @@
+/// ====================================================================================================================
+/// \file       bench_port_debouncer.cpp
+/// \brief      Host benchmark: cost of one port scan of PortDebouncer compared with a per-pin debouncer loop.
+/// \details    Both debouncers get the same bouncing samples of all 16 pins. The per-pin loop is the classic
+///             implementation with one counter per pin. The numbers are host numbers: use them to compare the
+///             two implementations, not as Cortex-M7 cycle counts.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "port_debouncer.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Baseline
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Classic debouncer with one counter per pin (same behavior as PortDebouncer).
+/// --------------------------------------------------------------------------------------------------------------------
+struct PerPinDebouncer
+{
+    uint16_t state = 0;
+    uint16_t pressed = 0;
+    uint16_t released = 0;
+    uint8_t counts[16] = {};
+
+    void update(uint16_t sample)
+    {
+        pressed = 0;
+        released = 0;
+        for (unsigned pin = 0; pin < 16; pin++)
+        {
+            const uint16_t mask = static_cast<uint16_t>(1U << pin);
+            if ((sample & mask) == (state & mask))
+            {
+                counts[pin] = 0;
+                continue;
+            }
+            if (++counts[pin] == 4)
+            {
+                counts[pin] = 0;
+                state ^= mask;
+                pressed |= static_cast<uint16_t>(mask & state);
+                released |= static_cast<uint16_t>(mask & ~state);
+            }
+        }
+    }
+};
+
+
+//======================================================================================================================
+// MARK: Benchmark
+//======================================================================================================================
+
+int main()
+{
+    constexpr std::size_t sampleCount = 4096;
+    constexpr unsigned rounds = 2000;
+
+    // Bouncing samples:
+    std::mt19937 rng(1);
+    std::vector<uint16_t> samples(sampleCount);
+    uint16_t level = 0;
+    for (uint16_t& sample : samples)
+    {
+        if (rng() % 32 == 0)
+        {
+            level ^= static_cast<uint16_t>(1U << (rng() % 16));
+        }
+        sample = level ^ static_cast<uint16_t>(((rng() % 4) == 0) ? (1U << (rng() % 16)) : 0);
+    }
+
+    // Vertical counters:
+    PortDebouncer vertical;
+    uint32_t verticalEdges = 0;
+    uint64_t start = benchNow();
+    for (unsigned round = 0; round < rounds; round++)
+    {
+        for (uint16_t sample : samples)
+        {
+            vertical.update(sample);
+            verticalEdges += vertical.pressed() | vertical.released();
+        }
+    }
+    const uint64_t verticalTime = benchNow() - start;
+    benchKeep(verticalEdges);
+
+    // Per-pin loop:
+    PerPinDebouncer perPin;
+    uint32_t perPinEdges = 0;
+    start = benchNow();
+    for (unsigned round = 0; round < rounds; round++)
+    {
+        for (uint16_t sample : samples)
+        {
+            perPin.update(sample);
+            perPinEdges += perPin.pressed | perPin.released;
+        }
+    }
+    const uint64_t perPinTime = benchNow() - start;
+    benchKeep(perPinEdges);
+
+    const double scans = static_cast<double>(sampleCount) * rounds;
+    std::printf("PortDebouncer (vertical counters): %6.2f %s per port scan\n", static_cast<double>(verticalTime) / scans, benchUnit());
+    std::printf("Per-pin counter loop:              %6.2f %s per port scan\n", static_cast<double>(perPinTime) / scans, benchUnit());
+
+    // Both implementations must agree, otherwise the comparison is meaningless:
+    if (vertical.state() != perPin.state || verticalEdges != perPinEdges)
+    {
+        std::printf("FAILED: results differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+/// ====================================================================================================================
+/// \file       test_clock_governor.cpp
+/// \brief      Host test of the clock governor with single windows and with the replay of a synthetic load trace.
+/// \details    Checks:
+///             - Step up: a load of 75 % jumps from any operating point directly to the fastest, 74 % does not.
+///             - Step down: only after 5 consecutive windows with low projected load, one operating point per step.
+///             - Hysteresis: no switch while the load stays inside the band between both thresholds.
+///             - Residency: the accounted time per operating point.
+///             The trace (Data/clock_governor_trace.csv) is replayed like on target: the busy cycles (the work) are
+///             given at 480 MHz, the window is scaled to the CPU frequency of the selected operating point.
+///             The trace is hand-written to cover typical load phases, it is not a measurement on target.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "clock_governor.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Test Setup
+//======================================================================================================================
+constexpr std::size_t opCount = 3;
+constexpr uint32_t cpuFreqsHz[opCount] = {480000000, 240000000, 120000000}; // Same as clock_scaling.hpp.
+constexpr uint32_t windowCycles = 48000000; // 100 ms at 480 MHz.
+constexpr uint32_t windowTicks = 100;       // 100 ms at 1 kHz tick.
+
+using Governor = ClockGovernor<opCount>;
+
+/// One window of the synthetic trace.
+struct TraceWindow
+{
+    uint32_t busyCycles;
+    uint32_t windowCycles;
+};
+
+/// Switch of the operating point after the evaluation of a window (window numbers start at 1).
+struct Switch
+{
+    std::size_t window;
+    std::size_t toIndex;
+
+    bool operator==(const Switch&) const = default;
+};
+
+
+/// Returns the percentage of the window in cycles of the given operating point.
+static uint32_t load(uint32_t percent, std::size_t index = 0)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(cpuFreqsHz[index] / 10) * percent) / 100);
+}
+
+
+/// Evaluates a window with the given load at the current operating point.
+static std::size_t evaluate(Governor& governor, uint32_t percent)
+{
+    const std::size_t index = governor.current();
+    governor.accountTime(windowTicks);
+    return governor.evaluate(load(percent, index), cpuFreqsHz[index] / 10);
+}
+
+
+/// Reads the trace file. Lines starting with '#' and the header line are skipped.
+static std::vector<TraceWindow> readTrace(const char* fileName)
+{
+    std::vector<TraceWindow> trace;
+    std::ifstream file(fileName);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        TraceWindow window = {};
+        if (!line.empty() && line[0] != '#' && std::sscanf(line.c_str(), "%u,%u", &window.busyCycles, &window.windowCycles) == 2)
+        {
+            trace.push_back(window);
+        }
+    }
+    return trace;
+}
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Step up at 75 % from every operating point.
+static void testStepUp()
+{
+    for (std::size_t start = 1; start < opCount; start++)
+    {
+        Governor governor(cpuFreqsHz, {.downDelayWindows = 1});
+        while (governor.current() < start)
+        {
+            evaluate(governor, 1);
+        }
+        CHECK(evaluate(governor, 74) == start);
+        CHECK(evaluate(governor, 75) == 0);
+    }
+}
+
+
+/// Step down after 5 windows, one operating point per step. An interruption restarts the delay.
+static void testStepDownDelay()
+{
+    Governor governor(cpuFreqsHz);
+    for (int window = 1; window <= 4; window++)
+    {
+        CHECK(evaluate(governor, 10) == 0);
+    }
+    CHECK(evaluate(governor, 10) == 1);
+
+    // Interrupted by a window with a projected load of 40 % (20 % at 240 MHz, 40 % projected to 120 MHz):
+    for (int window = 1; window <= 4; window++)
+    {
+        CHECK(evaluate(governor, 10) == 1);
+    }
+    CHECK(evaluate(governor, 20) == 1);
+    for (int window = 1; window <= 4; window++)
+    {
+        CHECK(evaluate(governor, 10) == 1);
+    }
+    CHECK(evaluate(governor, 10) == 2);
+
+    // Never below the slowest operating point:
+    for (int window = 1; window <= 10; window++)
+    {
+        CHECK(evaluate(governor, 0) == 2);
+    }
+
+    // Empty window:
+    CHECK(governor.evaluate(0, 0) == 2);
+    CHECK(governor.lastLoadPercent() == 0);
+}
+
+
+/// No switch inside the hysteresis band at every operating point.
+static void testHysteresisBand()
+{
+    // Band at operating point n: load < 75 % and load projected to n+1 >= 40 %.
+    const uint32_t bandLoads[opCount][2] = {{20, 74}, {20, 74}, {0, 74}};
+    for (std::size_t index = 0; index < opCount; index++)
+    {
+        Governor governor(cpuFreqsHz, {.downDelayWindows = 1});
+        while (governor.current() < index)
+        {
+            evaluate(governor, 1);
+        }
+        for (uint32_t percent = bandLoads[index][0]; percent <= bandLoads[index][1]; percent++)
+        {
+            for (int window = 1; window <= 10; window++)
+            {
+                CHECK(evaluate(governor, percent) == index);
+            }
+        }
+    }
+}
+
+
+/// Residency is accounted to the operating point, which is current before the evaluation.
+static void testResidency()
+{
+    Governor governor(cpuFreqsHz, {.downDelayWindows = 1});
+    governor.accountTime(7);
+    governor.evaluate(load(1), windowCycles); // -> 1
+    governor.accountTime(11);
+    governor.accountTime(13);
+    governor.evaluate(load(100), windowCycles); // -> 0
+    governor.accountTime(17);
+    CHECK(governor.residencyTicks(0) == 24);
+    CHECK(governor.residencyTicks(1) == 24);
+    CHECK(governor.residencyTicks(2) == 0);
+}
+
+
+/// Replays the synthetic trace.
+static void testTraceReplay()
+{
+    const std::vector<TraceWindow> trace = readTrace(TEST_DATA_DIR "/clock_governor_trace.csv");
+    CHECK(trace.size() == 97);
+
+    Governor governor(cpuFreqsHz);
+    const ClockGovernorConfig config;
+    std::vector<Switch> switches;
+    uint64_t windowsAt[opCount] = {};
+    std::size_t windowsSinceSwitch = 0;
+    for (std::size_t i = 0; i < trace.size(); i++)
+    {
+        // Window at the current operating point:
+        const std::size_t fromIndex = governor.current();
+        const uint32_t window = static_cast<uint32_t>((static_cast<uint64_t>(trace[i].windowCycles) * cpuFreqsHz[fromIndex]) / cpuFreqsHz[0]);
+        const uint32_t busy = std::min(trace[i].busyCycles, window);
+        windowsAt[fromIndex]++;
+        windowsSinceSwitch++;
+
+        governor.accountTime(windowTicks);
+        const std::size_t toIndex = governor.evaluate(busy, window);
+        const uint32_t loadPercent = governor.lastLoadPercent();
+        const bool slowest = (fromIndex + 1 == opCount);
+        const uint64_t projectedPercent = slowest ? 0 : (static_cast<uint64_t>(loadPercent) * cpuFreqsHz[fromIndex]) / cpuFreqsHz[fromIndex + 1];
+        if (loadPercent < config.upThresholdPercent && (slowest || projectedPercent >= config.downThresholdPercent))
+        {
+            // Inside the hysteresis band, the operating point never changes:
+            CHECK(toIndex == fromIndex);
+        }
+        if (toIndex < fromIndex)
+        {
+            CHECK(toIndex == 0);
+            CHECK(loadPercent >= config.upThresholdPercent);
+        }
+        else if (toIndex > fromIndex)
+        {
+            CHECK(toIndex == fromIndex + 1);
+            CHECK(windowsSinceSwitch >= config.downDelayWindows);
+            CHECK(projectedPercent < config.downThresholdPercent);
+        }
+
+        if (toIndex != fromIndex)
+        {
+            switches.push_back({i + 1, toIndex});
+            windowsSinceSwitch = 0;
+        }
+    }
+
+    // Expected switches, see the comments in the trace file:
+    const std::vector<Switch> expected = {{5, 1}, {10, 2}, {13, 0}, {52, 1}, {88, 0}};
+    CHECK(switches == expected);
+    for (const Switch& s : switches)
+    {
+        std::printf("window %3zu: -> operating point %zu\n", s.window, s.toIndex);
+    }
+
+    // Residency:
+    uint64_t totalTicks = 0;
+    for (std::size_t index = 0; index < opCount; index++)
+    {
+        CHECK(governor.residencyTicks(index) == windowsAt[index] * windowTicks);
+        totalTicks += governor.residencyTicks(index);
+    }
+    CHECK(totalTicks == trace.size() * windowTicks);
+    CHECK(governor.residencyTicks(0) == 53 * windowTicks);
+    CHECK(governor.residencyTicks(1) == 41 * windowTicks);
+    CHECK(governor.residencyTicks(2) == 3 * windowTicks);
+}
+
+
+int main()
+{
+    testStepUp();
+    testStepDownDelay();
+    testHysteresisBand();
+    testResidency();
+    testTraceReplay();
+    return testResult();
+}
@@ -0,0 +1,87 @@
+/// ====================================================================================================================
+/// \file       test_common.hpp
+/// \brief      Minimal helpers for the host tests and benchmarks (no test framework needed).
+/// \details    Tests:
+///                 CHECK(a == b);          // Prints the failed expression and continues.
+///                 return testResult();    // Exit code for CTest: 0 = all checks passed.
+///             Benchmarks:
+///                 uint64_t start = benchNow();
+///                 ...
+///                 printf("%.2f %s per item\n", double(benchNow() - start) / items, benchUnit());
+/// ====================================================================================================================
+#pragma once
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+//======================================================================================================================
+// MARK: Checks
+//======================================================================================================================
+
+/// Number of failed checks.
+inline int testFailures = 0;
+
+/// Counts and prints a failed check.
+inline void testCheck(bool passed, const char* expression, const char* file, int line)
+{
+    if (!passed)
+    {
+        testFailures++;
+        std::printf("%s:%d: CHECK failed: %s\n", file, line, expression);
+    }
+}
+
+#define CHECK(expression) testCheck(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+/// Prints the summary and returns the exit code of the test.
+inline int testResult()
+{
+    if (testFailures != 0)
+    {
+        std::printf("FAILED: %d check(s)\n", testFailures);
+        return 1;
+    }
+    std::printf("PASSED\n");
+    return 0;
+}
+
+
+//======================================================================================================================
+// MARK: Benchmarks
+//======================================================================================================================
+
+/// Returns a time stamp: CPU time stamp counter cycles on x86, otherwise nanoseconds.
+inline uint64_t benchNow()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// Returns the unit of benchNow().
+inline const char* benchUnit()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return "TSC cycles";
+#else
+    return "ns";
+#endif
+}
+
+/// Keeps the compiler from optimizing away a benchmark result.
+template <typename T>
+inline void benchKeep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
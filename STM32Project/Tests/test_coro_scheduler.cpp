@@ -0,0 +1,259 @@
+/// ====================================================================================================================
+/// \file       test_coro_scheduler.cpp
+/// \brief      Host test of the coroutine scheduler with the simulated ThreadX tick of Stubs/tx_api.h.
+/// \details    Scheduler::run() never returns. Each test sets hostTx::sleepBudget, so the first sleep beyond the
+///             budget throws hostTx::Stop and ends run().
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include "coro_scheduler.hpp"
+#include "test_common.hpp"
+
+using namespace rtos::literals;
+
+
+//======================================================================================================================
+// MARK: Helper
+//======================================================================================================================
+
+/// Runs the scheduler until a sleep would exceed the given ticks from now.
+static void runFor(coro::Scheduler& scheduler, uint64_t ticks)
+{
+    hostTx::sleepBudget = ticks;
+    try
+    {
+        scheduler.run();
+    }
+    catch (const hostTx::Stop&)
+    {
+    }
+}
+
+
+/// Starts the simulation at the given tick.
+static void resetSimulation(ULONG startTick)
+{
+    hostTx::ticks = startTick;
+    hostTx::sleeps = 0;
+    hostTx::sleepBudget = UINT64_MAX;
+}
+
+
+//======================================================================================================================
+// MARK: Tasks
+//======================================================================================================================
+
+static coro::Task periodicTask(rtos::Ticks period, uint32_t* counter, ULONG* lastTick)
+{
+    for (;;)
+    {
+        co_await coro::delay(period);
+        (*counter)++;
+        *lastTick = tx_time_get();
+    }
+}
+
+
+static coro::Task eventFlagsTask(TX_EVENT_FLAGS_GROUP* group, UINT* status, ULONG* resumeTick, ULONG* actualFlags)
+{
+    status[0] = co_await coro::eventFlags(group, 0x2, TX_OR_CLEAR, actualFlags, 50_ticks);
+    resumeTick[0] = tx_time_get();
+    tx_event_flags_set(group, 0x2, TX_OR);
+    status[1] = co_await coro::eventFlags(group, 0x2, TX_OR_CLEAR, actualFlags, 50_ticks);
+    resumeTick[1] = tx_time_get();
+}
+
+
+static coro::Task eventFlagsForeverTask(TX_EVENT_FLAGS_GROUP* group, UINT* status, ULONG* resumeTick, ULONG* actualFlags)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        status[i] = co_await coro::eventFlags(group, 0x2, TX_OR_CLEAR, actualFlags);
+        resumeTick[i] = tx_time_get();
+    }
+}
+
+
+static coro::Task semaphoreTask(TX_SEMAPHORE* sem, UINT* status, ULONG* resumeTick)
+{
+    *status = co_await coro::semaphore(sem);
+    *resumeTick = tx_time_get();
+}
+
+
+static coro::Task putSemaphoreTask(TX_SEMAPHORE* sem, rtos::Ticks delay)
+{
+    co_await coro::delay(delay);
+    tx_semaphore_put(sem);
+}
+
+
+static coro::Task yieldTask()
+{
+    for (;;)
+    {
+        co_await coro::yield();
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Only delays: the hosting thread sleeps until the next delay expires, it does not poll every tick.
+static void testDelaysSleepUntilEarliestDeadline()
+{
+    resetSimulation(0xFFFFFF00); // Including a wrap-around of the tick counter.
+    TX_EVENT_FLAGS_GROUP wakeUp;
+    uint32_t count100 = 0;
+    uint32_t count30 = 0;
+    ULONG last100 = 0;
+    ULONG last30 = 0;
+    {
+        coro::Scheduler scheduler;
+        scheduler.init(&wakeUp, 0x1);
+        CHECK(scheduler.spawn(periodicTask(100_ticks, &count100, &last100)));
+        CHECK(scheduler.spawn(periodicTask(30_ticks, &count30, &last30)));
+        runFor(scheduler, 1000);
+    }
+    CHECK(count100 == 10);
+    CHECK(count30 == 33);
+    CHECK(last100 == static_cast<ULONG>(0xFFFFFF00 + 1000));
+    CHECK(last30 == static_cast<ULONG>(0xFFFFFF00 + 990));
+    CHECK(hostTx::sleeps <= count100 + count30); // Max. one sleep per expired delay (polling: 1000 sleeps).
+    CHECK(coro::frameArena.used() == 0);
+}
+
+
+/// Event flags time out after the given timeout. Flags, which are already set, end the wait in the next pass.
+static void testEventFlagsTimeout()
+{
+    resetSimulation(0);
+    TX_EVENT_FLAGS_GROUP group;
+    UINT status[2] = {0xFF, 0xFF};
+    ULONG resumeTick[2] = {0, 0};
+    ULONG actualFlags = 0;
+    {
+        coro::Scheduler scheduler;
+        CHECK(scheduler.spawn(eventFlagsTask(&group, status, resumeTick, &actualFlags)));
+        runFor(scheduler, 1000);
+        CHECK(scheduler.taskCount() == 0);
+    }
+    CHECK(status[0] == TX_NO_EVENTS);
+    CHECK(resumeTick[0] == 50);
+    CHECK(status[1] == TX_SUCCESS);
+    CHECK(resumeTick[1] == 50);
+    CHECK(actualFlags == 0x2);
+    CHECK(group.tx_event_flags_group_current == 0);
+}
+
+
+/// A semaphore wait without timeout ends, when another task puts the semaphore. The waits are not polled.
+static void testSemaphore()
+{
+    resetSimulation(0);
+    TX_EVENT_FLAGS_GROUP wakeUp;
+    TX_SEMAPHORE sem;
+    UINT status = 0xFF;
+    ULONG resumeTick = 0;
+    {
+        coro::Scheduler scheduler;
+        scheduler.init(&wakeUp, 0x1);
+        CHECK(scheduler.spawn(semaphoreTask(&sem, &status, &resumeTick)));
+        CHECK(scheduler.spawn(putSemaphoreTask(&sem, 20_ticks)));
+        runFor(scheduler, 1000);
+        CHECK(scheduler.taskCount() == 0);
+    }
+    CHECK(status == TX_SUCCESS);
+    CHECK(resumeTick == 20);
+    CHECK(hostTx::sleeps == 1); // One sleep of 20 ticks (polling: 20 sleeps of one tick).
+}
+
+
+/// Event flags set and semaphores put from outside (e.g. an interrupt) wake up the sleeping hosting thread
+/// via the notify callbacks. Without a timeout, the hosting thread sleeps as long as possible.
+static void testNotifyWakesUpHostingThread()
+{
+    resetSimulation(0);
+    TX_EVENT_FLAGS_GROUP wakeUp;
+    TX_EVENT_FLAGS_GROUP group;
+    TX_SEMAPHORE sem;
+    UINT flagsStatus[2] = {0xFF, 0xFF};
+    ULONG flagsResumeTick[2] = {0, 0};
+    ULONG actualFlags = 0;
+    UINT semStatus = 0xFF;
+    ULONG semResumeTick = 0;
+    {
+        coro::Scheduler scheduler;
+        scheduler.init(&wakeUp, 0x1);
+        CHECK(scheduler.spawn(eventFlagsForeverTask(&group, flagsStatus, flagsResumeTick, &actualFlags)));
+        CHECK(scheduler.spawn(semaphoreTask(&sem, &semStatus, &semResumeTick)));
+
+        // Both tasks wait without timeout: the hosting thread sleeps until it is woken up.
+        runFor(scheduler, 1000);
+        CHECK(hostTx::sleeps == 0);
+        CHECK(wakeUp.tx_event_flags_group_current == 0);
+
+        // "Interrupt" while the hosting thread sleeps:
+        hostTx::ticks += 7;
+        tx_event_flags_set(&group, 0x2, TX_OR);
+        CHECK(wakeUp.tx_event_flags_group_current == 0x1);
+        runFor(scheduler, 1000);
+        CHECK(flagsStatus[0] == TX_SUCCESS);
+        CHECK(flagsResumeTick[0] == 7);
+
+        hostTx::ticks += 5;
+        tx_semaphore_put(&sem);
+        CHECK(wakeUp.tx_event_flags_group_current == 0x1);
+        runFor(scheduler, 1000);
+        CHECK(semStatus == TX_SUCCESS);
+        CHECK(semResumeTick == 12);
+
+        // The next set ends the second wait:
+        hostTx::ticks += 3;
+        tx_event_flags_set(&group, 0x2, TX_OR);
+        runFor(scheduler, 1000);
+        CHECK(flagsStatus[1] == TX_SUCCESS);
+        CHECK(flagsResumeTick[1] == 15);
+        CHECK(scheduler.taskCount() == 0);
+    }
+    CHECK(hostTx::sleeps == 0); // Only woken up, never slept until a timeout.
+}
+
+
+/// spawn() fails, if the arena is exhausted, and wakes up the hosting thread otherwise.
+static void testSpawn()
+{
+    resetSimulation(0);
+    TX_EVENT_FLAGS_GROUP wakeUp;
+    {
+        coro::Scheduler scheduler;
+        scheduler.init(&wakeUp, 0x4);
+        for (std::size_t i = 0; i < coro::frameBlockCount; i++)
+        {
+            CHECK(scheduler.spawn(yieldTask()));
+        }
+        CHECK(wakeUp.tx_event_flags_group_current == 0x4);
+        CHECK(coro::frameArena.used() == coro::frameBlockCount);
+        CHECK(!scheduler.spawn(yieldTask()));
+        CHECK(scheduler.taskCount() == coro::frameBlockCount);
+    }
+    CHECK(coro::frameArena.used() == 0);
+    CHECK(coro::frameArena.maxFrameSize() <= coro::frameBlockSize);
+}
+
+
+int main()
+{
+    testDelaysSleepUntilEarliestDeadline();
+    testEventFlagsTimeout();
+    testSemaphore();
+    testNotifyWakesUpHostingThread();
+    testSpawn();
+    return testResult();
+}
@@ -0,0 +1,84 @@
+/// ====================================================================================================================
+/// \file       test_cpu_load.cpp
+/// \brief      Host test of the idle time meter with a simulated sequence of ThreadX scheduler hooks.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include "cpu_load.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Test Setup
+//======================================================================================================================
+
+/// Simulated clock.
+struct TestClock
+{
+    static inline uint32_t time = 0;
+
+    static uint32_t now()
+    {
+        return time;
+    }
+};
+
+static TX_THREAD thrdMain;
+static TX_THREAD thrdBackground;
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Runs a schedule of thread switches starting at the given clock value.
+static void testSchedule(uint32_t start)
+{
+    IdleTimeMeter<TestClock> meter;
+    meter.setIdleThread(&thrdBackground);
+    TestClock::time = start;
+
+    // Initialization before the scheduler start is busy:
+    TestClock::time += 100;
+    CHECK(meter.idleTime() == 0);
+
+    // Main runs 50, Background (idle) 30:
+    meter.threadEnter(&thrdMain);
+    TestClock::time += 50;
+    meter.threadExit();
+    meter.threadEnter(&thrdBackground);
+    TestClock::time += 30;
+    CHECK(meter.idleTime() == 30); // Including the current idle period.
+
+    // Background is preempted by Main, which runs 20:
+    meter.threadExit();
+    meter.threadEnter(&thrdMain);
+    TestClock::time += 20;
+    CHECK(meter.idleTime() == 30);
+
+    // Main sleeps, no thread runs for 15 (idle), then Main again for 5:
+    meter.threadExit();
+    TestClock::time += 15;
+    CHECK(meter.idleTime() == 45);
+    meter.threadEnter(&thrdMain);
+    TestClock::time += 5;
+    CHECK(meter.idleTime() == 45);
+
+    // Load of the window from Main's point of view: window 120, idle 45, busy 75:
+    const uint32_t windowStart = start + 100;
+    const uint32_t window = TestClock::now() - windowStart;
+    CHECK(window == 120);
+    CHECK(window - meter.idleTime() == 75);
+}
+
+
+int main()
+{
+    testSchedule(0);
+    testSchedule(0xFFFFFF80); // Wrap-around of the clock during the schedule.
+    return testResult();
+}
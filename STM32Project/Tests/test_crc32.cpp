@@ -0,0 +1,207 @@
+/// ====================================================================================================================
+/// \file       test_crc32.cpp
+/// \brief      Host test of the slice-by-8 CRC-32 and of the integrity scanner.
+/// \details    - CRC: standard check value, comparison with a bitwise reference for all lengths and alignments
+///               up to 1000 bytes, and split updates (as done by the scanner slices).
+///             - Scanner: learned and given reference CRCs, detection of a changed byte, slices across region
+///               boundaries, pass statistics with a simulated clock, throughput of passes shorter than one tick.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "crc32.hpp"
+#include "integrity_scanner.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Test Setup
+//======================================================================================================================
+
+/// Bitwise CRC-32 reference (IEEE 802.3 / zlib).
+static uint32_t referenceCrc32(const uint8_t* data, std::size_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+
+/// Simulated clock with a frequency of 1 kHz.
+struct TestClock
+{
+    static constexpr uint32_t frequencyHz = 1000;
+    static inline uint32_t time = 0;
+
+    static uint32_t now()
+    {
+        return time;
+    }
+};
+
+using Scanner = IntegrityScanner<Crc32Software, TestClock, 3>;
+
+
+/// Simulated cycle counter with the frequency of the fixed rate cycle counter (480 MHz).
+struct TestCycleClock
+{
+    static constexpr uint32_t frequencyHz = 480000000;
+    static inline uint32_t time = 0;
+
+    static uint32_t now()
+    {
+        return time;
+    }
+};
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Check value of the CRC-32 catalogue.
+static void testCheckValue()
+{
+    const char text[] = "123456789";
+    CHECK(Crc32Software::calculate(text, 9) == 0xCBF43926);
+    CHECK(Crc32Software::calculate(text, 0) == 0x00000000);
+}
+
+
+/// Comparison with the bitwise reference for all lengths and start alignments.
+static void testReference(const std::vector<uint8_t>& data)
+{
+    uint32_t errors = 0;
+    for (std::size_t offset = 0; offset < 8; offset++)
+    {
+        for (std::size_t size = 0; size < 1000; size++)
+        {
+            errors += (Crc32Software::calculate(&data[offset], size) != referenceCrc32(&data[offset], size)) ? 1 : 0;
+        }
+    }
+    CHECK(errors == 0);
+}
+
+
+/// A CRC continued over several updates is the same as the CRC over all bytes.
+static void testSplitUpdates(const std::vector<uint8_t>& data)
+{
+    constexpr std::size_t size = 257;
+    const uint32_t expected = referenceCrc32(&data[0], size);
+    uint32_t errors = 0;
+    for (std::size_t split = 0; split <= size; split++)
+    {
+        uint32_t crc = Crc32Software::update(crc32Init, &data[0], split);
+        crc = Crc32Software::update(crc, &data[split], size - split);
+        errors += ((crc ^ crc32FinalXor) != expected) ? 1 : 0;
+    }
+    CHECK(errors == 0);
+}
+
+
+/// Scanner with learned and given reference CRCs.
+static void testScanner(std::vector<uint8_t> data)
+{
+    TestClock::time = 0xFFFFFFF0; // Wrap-around of the clock during the passes.
+    Scanner scanner;
+    CHECK(scanner.addRegion(&data[0], 100));
+    CHECK(scanner.addRegion(&data[100], 37, referenceCrc32(&data[100], 37)));
+    CHECK(scanner.addRegion(&data[137], 300, 0x12345678)); // Wrong reference.
+    CHECK(!scanner.addRegion(&data[437], 1));                // No slot free.
+    CHECK(scanner.throughputBytesPerSecond() == 0);
+
+    // First pass with 16 byte slices: 7 + 3 + 19 steps, 1 ms per step:
+    for (int step = 0; step < 29; step++)
+    {
+        CHECK(scanner.passes() == 0);
+        scanner.step(16);
+        TestClock::time++;
+    }
+    CHECK(scanner.passes() == 1);
+    CHECK(scanner.bytesScanned() == 437);
+    CHECK(scanner.region(0).hasReference);
+    CHECK(scanner.region(0).referenceCrc == referenceCrc32(&data[0], 100));
+    CHECK(scanner.region(0).mismatches == 0);
+    CHECK(scanner.region(1).mismatches == 0);
+    CHECK(scanner.region(2).mismatches == 1);
+    CHECK(scanner.mismatches() == 1);
+    CHECK(scanner.throughputBytesPerSecond() == 437 * 1000 / 28); // The last step ends the pass before the clock advances.
+
+    // Second pass with a changed byte in region 0, slices larger than the regions:
+    data[42] ^= 0x01;
+    for (int step = 0; step < 3; step++)
+    {
+        scanner.step(1024);
+    }
+    CHECK(scanner.passes() == 2);
+    CHECK(scanner.region(0).mismatches == 1);
+    CHECK(scanner.region(1).mismatches == 0);
+    CHECK(scanner.region(2).mismatches == 2);
+    CHECK(scanner.mismatches() == 3);
+    CHECK(scanner.throughputBytesPerSecond() == 437 * 1000); // Zero duration counts as one clock unit.
+
+    // Restored byte:
+    data[42] ^= 0x01;
+    for (int step = 0; step < 3; step++)
+    {
+        scanner.step(1024);
+    }
+    CHECK(scanner.passes() == 3);
+    CHECK(scanner.region(0).mismatches == 1);
+    CHECK(scanner.bytesScanned() == 3 * 437);
+}
+
+
+/// Throughput of passes, which are much shorter than one ThreadX tick (1 ms), measured with a cycle counter.
+static void testSubTickThroughput(const std::vector<uint8_t>& data)
+{
+    TestCycleClock::time = 0xFFFFF000; // Wrap-around of the counter during the first pass.
+    IntegrityScanner<Crc32Software, TestCycleClock, 2> scanner;
+    CHECK(scanner.addRegion(&data[0], 1000));
+    CHECK(scanner.addRegion(&data[1000], 24));
+
+    // 1024 bytes in 10 us (4800 cycles):
+    scanner.step(1024);
+    TestCycleClock::time += 4800;
+    scanner.step(1024);
+    CHECK(scanner.passes() == 1);
+    CHECK(scanner.throughputBytesPerSecond() == 1024ULL * 480000000 / 4800); // 102.4 MB/s, a 1 ms tick clock reports 1.024 MB/s.
+
+    // 1024 bytes in 100 cycles, more than 2^32 bytes per second:
+    scanner.step(1024);
+    TestCycleClock::time += 100;
+    scanner.step(1024);
+    CHECK(scanner.passes() == 2);
+    CHECK(scanner.throughputBytesPerSecond() == 1024ULL * 480000000 / 100);
+}
+
+
+int main()
+{
+    std::vector<uint8_t> data(1100);
+    std::mt19937 random(12345);
+    for (uint8_t& byte : data)
+    {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    testCheckValue();
+    testReference(data);
+    testSplitUpdates(data);
+    testScanner(data);
+    testSubTickThroughput(data);
+    return testResult();
+}
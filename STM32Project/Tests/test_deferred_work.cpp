@@ -0,0 +1,341 @@
+/// ====================================================================================================================
+/// \file       test_deferred_work.cpp
+/// \brief      Host tests of DeferredWorkQueue: wake-ups per batch and a stress test with many concurrent producers.
+/// \details    Wake-ups: hostTx::eventFlagSets counts the calls of tx_event_flags_set().
+///             - A burst of posts to the sleeping worker sets the event flag once.
+///             - Posts while the worker executes a batch do not set the event flag.
+///             Stress test: [producerCount] std::threads post numbered items as fast as possible into the queue
+///             (no retry on overflow), while the worker runs runWorker() in its own std::thread. The producers pause
+///             now and then, so the worker also goes to sleep and has to be woken up again.
+///             - No loss: every accepted item is executed exactly once, every rejected one is an overflow.
+///             - Order: the items of each producer are executed in the order of posting.
+///             - The max. depth never exceeds the capacity, the depth is 0 when all items are executed.
+///             - The latency histogram counts every executed item.
+///             runWorker() never returns: a last work item throws StopWorker to end the worker thread.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "deferred_work.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Test Setup
+//======================================================================================================================
+constexpr uint32_t producerCount = 8;
+constexpr uint32_t postsPerProducer = 20000;
+
+/// Time stamp source of the latency histogram.
+struct HostClock
+{
+    static uint32_t now()
+    {
+        return static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+};
+
+using Queue = DeferredWorkQueue<HostClock>;
+
+/// Payload of the work items.
+struct Item
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+/// Thrown by the last work item to end runWorker().
+struct StopWorker
+{
+};
+
+// Results, written by the worker thread only:
+static std::vector<std::vector<uint8_t>> executedItems(producerCount, std::vector<uint8_t>(postsPerProducer, 0));
+static int64_t lastSequence[producerCount];
+static uint32_t executedCount = 0;
+static uint32_t orderErrors = 0;
+static uint32_t duplicates = 0;
+
+// Wake-up tests:
+static std::atomic<bool> gateEntered{false};
+static std::atomic<bool> gateOpen{false};
+static uint32_t countedItems = 0; // Written by the worker thread only.
+
+
+//======================================================================================================================
+// MARK: Work Functions
+//======================================================================================================================
+
+static void workFct_Item(const void* payload)
+{
+    const Item item = *static_cast<const Item*>(payload);
+    if (static_cast<int64_t>(item.sequence) <= lastSequence[item.producer])
+    {
+        orderErrors++;
+    }
+    lastSequence[item.producer] = item.sequence;
+    if (executedItems[item.producer][item.sequence]++ != 0)
+    {
+        duplicates++;
+    }
+    executedCount++;
+}
+
+
+static void workFct_Stop(const void*)
+{
+    throw StopWorker{};
+}
+
+
+/// Holds the worker until gateOpen is set, like an interrupt which preempts the worker thread.
+static void workFct_Gate(const void*)
+{
+    gateEntered = true;
+    while (!gateOpen)
+    {
+        std::this_thread::yield();
+    }
+}
+
+
+static void workFct_Count(const void* payload)
+{
+    if (*static_cast<const uint32_t*>(payload) == countedItems)
+    {
+        countedItems++;
+    }
+}
+
+
+//======================================================================================================================
+// MARK: Helper
+//======================================================================================================================
+
+/// Runs the worker of the queue in its own std::thread until workFct_Stop() is executed.
+static std::thread startWorker(Queue& queue)
+{
+    return std::thread([&queue]() {
+        try
+        {
+            queue.runWorker();
+        }
+        catch (const StopWorker&)
+        {
+        }
+    });
+}
+
+
+/// Posts the stop item and waits for the end of the worker thread.
+static void stopWorker(Queue& queue, std::thread& worker)
+{
+    while (!queue.post(&workFct_Stop))
+    {
+        std::this_thread::yield();
+    }
+    worker.join();
+}
+
+
+/// Waits until the queue is empty and the worker waits for the event flag. Returns false on timeout.
+static bool waitUntilWorkerSleeps(Queue& queue, TX_EVENT_FLAGS_GROUP& evtFlags)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(evtFlags.mutex);
+            if (queue.depth() == 0 && evtFlags.tx_event_flags_group_suspended_count == 1)
+            {
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// A burst of posts to the sleeping worker sets the event flag once. The first item holds the worker until the
+/// burst is complete, so all items of the burst are pending at the same time.
+static void testBurstWakesUpOnce()
+{
+    static Queue queue;
+    TX_EVENT_FLAGS_GROUP evtFlags;
+    queue.init(&evtFlags, 0x1);
+    gateEntered = false;
+    gateOpen = false;
+    countedItems = 0;
+
+    std::thread worker = startWorker(queue);
+    CHECK(waitUntilWorkerSleeps(queue, evtFlags));
+    const uint32_t setsBefore = hostTx::eventFlagSets;
+
+    CHECK(queue.post(&workFct_Gate));
+    for (uint32_t i = 0; i < Queue::capacity - 1; i++)
+    {
+        CHECK(queue.post(&workFct_Count, i));
+    }
+    CHECK(hostTx::eventFlagSets - setsBefore == 1);
+
+    gateOpen = true;
+    CHECK(waitUntilWorkerSleeps(queue, evtFlags));
+    CHECK(countedItems == Queue::capacity - 1);
+    CHECK(hostTx::eventFlagSets - setsBefore == 1);
+    stopWorker(queue, worker);
+}
+
+
+/// Posts while the worker executes a batch do not set the event flag. After the batch, the worker arms the
+/// wake-up request again, so the next post sets the event flag.
+static void testPostsWhileDrainingDoNotWakeUp()
+{
+    static Queue queue;
+    TX_EVENT_FLAGS_GROUP evtFlags;
+    queue.init(&evtFlags, 0x1);
+    gateEntered = false;
+    gateOpen = false;
+    countedItems = 0;
+
+    std::thread worker = startWorker(queue);
+    CHECK(waitUntilWorkerSleeps(queue, evtFlags));
+    CHECK(queue.post(&workFct_Gate));
+    while (!gateEntered)
+    {
+        std::this_thread::yield();
+    }
+    const uint32_t setsBefore = hostTx::eventFlagSets;
+
+    for (uint32_t i = 0; i < Queue::capacity - 1; i++)
+    {
+        CHECK(queue.post(&workFct_Count, i));
+    }
+    CHECK(hostTx::eventFlagSets - setsBefore == 0);
+
+    gateOpen = true;
+    CHECK(waitUntilWorkerSleeps(queue, evtFlags));
+    CHECK(countedItems == Queue::capacity - 1);
+    CHECK(hostTx::eventFlagSets - setsBefore == 0);
+
+    const uint32_t next = Queue::capacity - 1;
+    CHECK(queue.post(&workFct_Count, next));
+    CHECK(waitUntilWorkerSleeps(queue, evtFlags));
+    CHECK(countedItems == Queue::capacity);
+    CHECK(hostTx::eventFlagSets - setsBefore == 1);
+    stopWorker(queue, worker);
+}
+
+
+/// Concurrent producers: no loss, order per producer and statistics.
+static void testStress()
+{
+    static Queue queue;
+    TX_EVENT_FLAGS_GROUP evtFlags;
+    queue.init(&evtFlags, 0x1);
+    for (int64_t& last : lastSequence)
+    {
+        last = -1;
+    }
+
+    std::thread worker = startWorker(queue);
+
+    // Producers:
+    std::vector<std::vector<uint8_t>> acceptedItems(producerCount, std::vector<uint8_t>(postsPerProducer, 0));
+    uint32_t rejected[producerCount] = {};
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < producerCount; p++)
+    {
+        producers.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < postsPerProducer; i++)
+            {
+                if (queue.post(&workFct_Item, Item{p, i}))
+                {
+                    acceptedItems[p][i] = 1;
+                }
+                else
+                {
+                    rejected[p]++;
+                    std::this_thread::yield(); // Give the worker a chance, else nearly every post overflows.
+                }
+                if ((i % 2000) == 1999)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200)); // Let the worker fall asleep.
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    // Wait until the worker has executed all items:
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (queue.depth() != 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(queue.depth() == 0);
+
+    // Stop the worker:
+    stopWorker(queue, worker);
+
+    // No loss and no duplicates:
+    uint32_t acceptedCount = 0;
+    uint32_t rejectedCount = 0;
+    uint32_t lost = 0;
+    uint32_t unexpected = 0;
+    for (uint32_t p = 0; p < producerCount; p++)
+    {
+        rejectedCount += rejected[p];
+        for (uint32_t i = 0; i < postsPerProducer; i++)
+        {
+            acceptedCount += acceptedItems[p][i];
+            lost += (acceptedItems[p][i] != 0 && executedItems[p][i] == 0) ? 1 : 0;
+            unexpected += (acceptedItems[p][i] == 0 && executedItems[p][i] != 0) ? 1 : 0;
+        }
+    }
+    CHECK(acceptedCount + rejectedCount == producerCount * postsPerProducer);
+    CHECK(executedCount == acceptedCount);
+    CHECK(lost == 0);
+    CHECK(unexpected == 0);
+    CHECK(duplicates == 0);
+
+    // Order per producer:
+    CHECK(orderErrors == 0);
+
+    // Statistics:
+    CHECK(queue.overflows() == rejectedCount);
+    CHECK(queue.maxDepth() <= Queue::capacity);
+    CHECK(queue.maxDepth() > 1);
+    uint32_t histogramCount = 0;
+    for (std::size_t bin = 0; bin < Queue::histogramBins; bin++)
+    {
+        histogramCount += queue.latencyHistogram(bin);
+    }
+    CHECK(histogramCount == executedCount + 1); // Including the stop item.
+
+    std::printf("posted %u, executed %u, overflows %u, max. depth %u of %zu\n",
+                producerCount * postsPerProducer, executedCount, queue.overflows(), queue.maxDepth(), Queue::capacity);
+}
+
+
+int main()
+{
+    testBurstWakesUpOnce();
+    testPostsWhileDrainingDoNotWakeUp();
+    testStress();
+    return testResult();
+}
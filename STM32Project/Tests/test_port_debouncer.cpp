@@ -0,0 +1,164 @@
+/// ====================================================================================================================
+/// \file       test_port_debouncer.cpp
+/// \brief      Host test of PortDebouncer against a per-pin reference model.
+/// \details    - Exhaustive: every input sequence of [sequenceLength] samples from both initial states.
+///               The 16 pins of one debouncer run 16 different sequences at once.
+///             - Random: long sequences with random bouncing on all pins.
+///             After every sample the debounced state and both edge masks must match the model.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <cstdint>
+#include <random>
+#include "port_debouncer.hpp"
+#include "test_common.hpp"
+
+
+//======================================================================================================================
+// MARK: Reference Model
+//======================================================================================================================
+
+/// --------------------------------------------------------------------------------------------------------------------
+/// \brief    Straightforward debouncer of one pin: 4 consecutive samples different from the state toggle it.
+/// --------------------------------------------------------------------------------------------------------------------
+struct PinModel
+{
+    bool state = false;
+    uint32_t count = 0;
+    bool pressed = false;
+    bool released = false;
+
+    void update(bool sample)
+    {
+        pressed = false;
+        released = false;
+        if (sample == state)
+        {
+            count = 0;
+            return;
+        }
+        count++;
+        if (count == 4)
+        {
+            count = 0;
+            state = sample;
+            pressed = state;
+            released = !state;
+        }
+    }
+};
+
+
+/// Feeds one sample into the debouncer and the 16 pin models and compares them.
+static void updateAndCompare(PortDebouncer& debouncer, PinModel (&models)[16], uint16_t sample)
+{
+    debouncer.update(sample);
+
+    uint16_t state = 0;
+    uint16_t pressed = 0;
+    uint16_t released = 0;
+    for (unsigned pin = 0; pin < 16; pin++)
+    {
+        models[pin].update((sample >> pin) & 1);
+        state |= static_cast<uint16_t>(models[pin].state << pin);
+        pressed |= static_cast<uint16_t>(models[pin].pressed << pin);
+        released |= static_cast<uint16_t>(models[pin].released << pin);
+    }
+    CHECK(debouncer.state() == state);
+    CHECK(debouncer.pressed() == pressed);
+    CHECK(debouncer.released() == released);
+}
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Every sequence of [sequenceLength] samples from both initial states.
+static void testExhaustive()
+{
+    constexpr unsigned sequenceLength = 12;
+    constexpr unsigned sequenceCount = 1U << sequenceLength;
+    constexpr unsigned pinRuns = 2 * sequenceCount; // Both initial states.
+
+    for (unsigned run = 0; run < pinRuns; run += 16)
+    {
+        uint16_t initialState = 0;
+        PinModel models[16];
+        for (unsigned pin = 0; pin < 16; pin++)
+        {
+            models[pin].state = ((run + pin) / sequenceCount) != 0;
+            initialState |= static_cast<uint16_t>(models[pin].state << pin);
+        }
+
+        PortDebouncer debouncer(initialState);
+        for (unsigned step = 0; step < sequenceLength; step++)
+        {
+            uint16_t sample = 0;
+            for (unsigned pin = 0; pin < 16; pin++)
+            {
+                const unsigned sequence = (run + pin) % sequenceCount;
+                sample |= static_cast<uint16_t>(((sequence >> step) & 1) << pin);
+            }
+            updateAndCompare(debouncer, models, sample);
+        }
+    }
+}
+
+
+/// Long random sequences: each pin holds a level and bounces with a given probability.
+static void testRandom()
+{
+    std::mt19937 rng(12345);
+    for (unsigned bounceRange : {2U, 4U, 8U, 64U})
+    {
+        PortDebouncer debouncer;
+        PinModel models[16];
+        uint16_t level = 0;
+        for (unsigned step = 0; step < 200000; step++)
+        {
+            if (rng() % 32 == 0)
+            {
+                level ^= static_cast<uint16_t>(1U << (rng() % 16));
+            }
+            uint16_t bounce = 0;
+            for (unsigned pin = 0; pin < 16; pin++)
+            {
+                bounce |= static_cast<uint16_t>(((rng() % bounceRange) == 0) << pin);
+            }
+            updateAndCompare(debouncer, models, level ^ bounce);
+        }
+    }
+}
+
+
+/// scan() reads the IDR of the given port.
+static void testScan()
+{
+    struct FakePort
+    {
+        volatile uint32_t IDR;
+    };
+    FakePort port{0xFFFF0001};
+    PortDebouncer debouncer;
+    for (int i = 0; i < 3; i++)
+    {
+        debouncer.scan(&port);
+        CHECK(debouncer.state() == 0);
+    }
+    debouncer.scan(&port);
+    CHECK(debouncer.state() == 0x0001);
+    CHECK(debouncer.pressed() == 0x0001);
+}
+
+
+int main()
+{
+    testExhaustive();
+    testRandom();
+    testScan();
+    return testResult();
+}
@@ -0,0 +1,98 @@
+/// ====================================================================================================================
+/// \file       test_rtos_time.cpp
+/// \brief      Host test of the tick durations, literals, time points and deadlines of rtos_time.hpp.
+/// ====================================================================================================================
+
+
+//======================================================================================================================
+// MARK: Inclusions
+//======================================================================================================================
+#include <chrono>
+#include <cstdint>
+#include "rtos_time.hpp"
+#include "test_common.hpp"
+
+using namespace rtos::literals;
+
+
+//======================================================================================================================
+// MARK: Compile Time Checks
+//======================================================================================================================
+static_assert(TX_TIMER_TICKS_PER_SECOND == 1000, "The expected values are for a 1 ms tick.");
+static_assert(10_ms == rtos::Ticks(10));
+static_assert(2_s == rtos::Ticks(2000));
+static_assert(7_ticks == rtos::Ticks(7));
+static_assert(1_us == rtos::Ticks(1), "Rounding up: a delay is never shorter.");
+static_assert(1000_us == rtos::Ticks(1));
+static_assert(1001_us == rtos::Ticks(2));
+static_assert(0_ms == rtos::Ticks::zero());
+static_assert(rtos::toTicks(std::chrono::minutes(1)) == rtos::Ticks(60000));
+static_assert(4294967294_ms == rtos::Ticks::max(), "The largest finite duration.");
+
+// Saturating arithmetic:
+static_assert(rtos::Ticks::waitForever() + 1_ms == rtos::Ticks::waitForever());
+static_assert(1_ms + rtos::Ticks::waitForever() == rtos::Ticks::waitForever());
+static_assert(rtos::Ticks::max() + 1_ticks == rtos::Ticks::max());
+static_assert(rtos::Ticks::max() + rtos::Ticks::max() == rtos::Ticks::max());
+static_assert(rtos::Ticks::waitForever() - 1_ms == rtos::Ticks::waitForever());
+static_assert(5_ms - 7_ms == rtos::Ticks::zero());
+static_assert(5_ms - rtos::Ticks::waitForever() == rtos::Ticks::zero());
+static_assert(7_ms - 5_ms == 2_ms);
+static_assert(3_ms + 4_ms == 7_ms);
+
+
+//======================================================================================================================
+// MARK: Tests
+//======================================================================================================================
+
+/// Runtime conversions give the same results as the compile time ones.
+static void testCeilTicks()
+{
+    volatile uint32_t millis = 1234;
+    volatile uint32_t micros = 1234567;
+    CHECK(rtos::ceilTicks(std::chrono::duration<uint32_t, std::milli>(millis)) == rtos::Ticks(1234));
+    CHECK(rtos::ceilTicks(std::chrono::duration<uint32_t, std::micro>(micros)) == rtos::Ticks(1235));
+    CHECK(rtos::ceilTicks(std::chrono::seconds(3)) == rtos::Ticks(3000));
+}
+
+
+/// Time point differences are wrap-around safe.
+static void testTickTimePoint()
+{
+    hostTx::ticks = 0xFFFFFFF0;
+    const rtos::TickTimePoint start = rtos::TickTimePoint::now();
+    hostTx::ticks = 0x10;
+    CHECK((rtos::TickTimePoint::now() - start) == rtos::Ticks(0x20));
+    CHECK((start + 0x20_ticks).ticks() == 0x10);
+}
+
+
+/// Deadlines expire after the duration and report the remaining ticks.
+static void testDeadline()
+{
+    hostTx::ticks = 0xFFFFFF00;
+    const rtos::Deadline deadline = rtos::Deadline::after(500_ms);
+    CHECK(!deadline.expired());
+    CHECK(deadline.remaining() == 500_ms);
+
+    hostTx::ticks += 499;
+    CHECK(!deadline.expired());
+    CHECK(deadline.remaining() == 1_ms);
+
+    hostTx::ticks += 1;
+    CHECK(deadline.expired());
+    CHECK(deadline.remaining() == rtos::Ticks::zero());
+
+    hostTx::ticks += 1000;
+    CHECK(deadline.expired());
+    CHECK(deadline.remaining() == rtos::Ticks::zero());
+}
+
+
+int main()
+{
+    testCeilTicks();
+    testTickTimePoint();
+    testDeadline();
+    return testResult();
+}